@@ -26,6 +26,8 @@ bool Application::Init()
 	// create the ECS system
 	flecsWorld = std::make_shared<flecs::world>();
 	uiWorld = std::make_shared<flecs::world>();
+	// Queries look up InScene for HiddenScene, which flecs only allows on acyclic relationships
+	flecsWorld->component<InScene>().add(flecs::Acyclic).add(flecs::Exclusive);
 
 	audioLoader = std::make_shared<AudioLoader>();
 	modelLoader = std::make_shared<ModelLoader>();
@@ -110,6 +112,7 @@ bool Application::Shutdown()
 	gameLogic.Shutdown();
 
 	modelLoader.reset();
+	saveLoader->Shutdown();
 	saveLoader.reset();
 	spriteLoader.reset();
 	audioLoader.reset();
@@ -2,6 +2,12 @@
 #ifndef PHYSICS_H
 #define PHYSICS_H
 
+// SSE is part of every x64 target, the batched sweep falls back to scalar tests elsewhere
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1) || defined(__SSE__)
+#define MAD_SWEEP_SSE
+#include <xmmintrin.h>
+#endif
+
 // example space game (avoid name collisions)
 using namespace GW::MATH;
 
@@ -66,6 +72,11 @@ namespace MAD
 				value = GZeroMatrixF;
 		}
 	};
+
+	// Transform at the start of the last fixed physics step
+	struct PreviousTransform { GMATRIXF value; };
+	// Transform blended between the last two physics steps, what moveables are drawn at
+	struct InterpolatedTransform { GMATRIXF value; };
 #pragma endregion
 
 #pragma region Rays
@@ -123,9 +134,202 @@ namespace MAD
 	};
 #pragma endregion
 
+#pragma region Flat Box Tests
+	// Box tests on plain floats, shared by BoxCollider and the packed ColliderStore passes 
+	// so both always produce the same results
+
+	// Matches GCollision::TestAABBToAABBF on the boxes' center / extent form, ignoring z
+	static inline bool TestBoxOverlap2D(
+		float _minX1, float _minY1, float _maxX1, float _maxY1,
+		float _minX2, float _minY2, float _maxX2, float _maxY2)
+	{
+		float centerX1 = (_minX1 + _maxX1) * 0.5f, centerY1 = (_minY1 + _maxY1) * 0.5f;
+		float centerX2 = (_minX2 + _maxX2) * 0.5f, centerY2 = (_minY2 + _maxY2) * 0.5f;
+
+		return !(abs(centerX1 - centerX2) > ((_maxX1 - centerX1) + (_maxX2 - centerX2)) ||
+			abs(centerY1 - centerY2) > ((_maxY1 - centerY1) + (_maxY2 - centerY2)));
+	}
+
+	// Normal of the face hit by a sweep, _xAxis is true when the x slab was entered last
+	static inline GVECTORF SweepNormal2D(bool _xAxis, float _moveX, float _moveY)
+	{
+		if (_xAxis)
+			if (_moveX < 0)
+				return { 1, 0, 0 , 0 };
+			else
+				return { -1, 0, 0, 0 };
+		else
+			if (_moveY < 0)
+				return { 0, 1, 0, 0 };
+			else
+				return { 0, -1, 0, 0 };
+	}
+
+	// Sweeps a box centered at _origin by _move against the box [_min, _max].
+	// The other box is expanded by our half size, so that the contact point is exactly 
+	// where we need to end up to not enter it, and a ray is cast from our center.
+	// Only returns true when the hit happens within this move (contactTime <= 1).
+	static inline bool SweepBox2D(
+		float _originX, float _originY, float _halfSizeX, float _halfSizeY,
+		float _moveX, float _moveY,
+		float _minX, float _minY, float _maxX, float _maxY,
+		RaycastHit& _hitResult)
+	{
+		float nearX = ((_minX - _halfSizeX) - _originX) / _moveX;
+		float nearY = ((_minY - _halfSizeY) - _originY) / _moveY;
+		float farX = ((_maxX + _halfSizeX) - _originX) / _moveX;
+		float farY = ((_maxY + _halfSizeY) - _originY) / _moveY;
+
+		if (std::isnan(farX) || std::isnan(farY)) return false;
+		if (std::isnan(nearX) || std::isnan(nearY)) return false;
+
+		if (nearX > farX) std::swap(nearX, farX);
+		if (nearY > farY) std::swap(nearY, farY);
+
+		if (nearX > farY || nearY > farX) return false;
+
+		_hitResult.contactTime = max(nearX, nearY);
+		float tHitFar = ((farX < farY) ? farX : farY);
+
+		if (tHitFar < 0) return false;
+
+		_hitResult.contactPoint = { _originX + _moveX * _hitResult.contactTime, _originY + _moveY * _hitResult.contactTime };
+		_hitResult.surfaceNormal = SweepNormal2D(nearX > nearY, _moveX, _moveY);
+
+		// Time is how far along the ray it hit the box, 
+		// if it's greater than 1, with current velocity this will not hit the other collider.
+		return _hitResult.contactTime <= 1.0f;
+	}
+
+#ifdef MAD_SWEEP_SSE
+	// SweepBox2D and the one-way rule of BoxCollider::DynamicCollisionCheck2D for 4 boxes at once.
+	// Every step uses the same operations in the same order as the scalar tests, and the min / max
+	// operand order matches their comparisons, so results are identical lane for lane.
+	// Returns a mask of the lanes that hit, with their contact times in _outContactTimes.
+	static inline int SweepBoxes2D4(
+		float _boxMinX, float _boxMinY, float _boxMaxX, float _boxMaxY,
+		float _halfSizeX, float _halfSizeY,
+		float _moveX, float _moveY,
+		const float* _minX, const float* _minY, const float* _maxX, const float* _maxY,
+		int _oneWayMask,
+		float* _outContactTimes)
+	{
+		if (_moveX == 0 && _moveY == 0)
+			return 0;
+
+		__m128 minX = _mm_loadu_ps(_minX);
+		__m128 minY = _mm_loadu_ps(_minY);
+		__m128 maxX = _mm_loadu_ps(_maxX);
+		__m128 maxY = _mm_loadu_ps(_maxY);
+
+		// One way boxes are only hit from above, and never when we already overlap them
+		int blockedMask = 0;
+		if (_oneWayMask != 0)
+		{
+			if (_moveY >= 0)
+				blockedMask = 0xF;
+			else
+			{
+				__m128 half = _mm_set1_ps(0.5f);
+				__m128 signBit = _mm_set1_ps(-0.0f);
+				float centerX = (_boxMinX + _boxMaxX) * 0.5f, centerY = (_boxMinY + _boxMaxY) * 0.5f;
+				__m128 otherCenterX = _mm_mul_ps(_mm_add_ps(minX, maxX), half);
+				__m128 otherCenterY = _mm_mul_ps(_mm_add_ps(minY, maxY), half);
+
+				__m128 apartX = _mm_cmpgt_ps(
+					_mm_andnot_ps(signBit, _mm_sub_ps(_mm_set1_ps(centerX), otherCenterX)),
+					_mm_add_ps(_mm_set1_ps(_boxMaxX - centerX), _mm_sub_ps(maxX, otherCenterX)));
+				__m128 apartY = _mm_cmpgt_ps(
+					_mm_andnot_ps(signBit, _mm_sub_ps(_mm_set1_ps(centerY), otherCenterY)),
+					_mm_add_ps(_mm_set1_ps(_boxMaxY - centerY), _mm_sub_ps(maxY, otherCenterY)));
+
+				blockedMask = ~_mm_movemask_ps(_mm_or_ps(apartX, apartY)) & 0xF;
+			}
+			blockedMask &= _oneWayMask;
+		}
+
+		__m128 originX = _mm_set1_ps(_boxMinX + .5f * (_boxMaxX - _boxMinX));
+		__m128 originY = _mm_set1_ps(_boxMinY + .5f * (_boxMaxY - _boxMinY));
+		__m128 halfSizeX = _mm_set1_ps(_halfSizeX);
+		__m128 halfSizeY = _mm_set1_ps(_halfSizeY);
+		__m128 moveX = _mm_set1_ps(_moveX);
+		__m128 moveY = _mm_set1_ps(_moveY);
+
+		__m128 nearX = _mm_div_ps(_mm_sub_ps(_mm_sub_ps(minX, halfSizeX), originX), moveX);
+		__m128 nearY = _mm_div_ps(_mm_sub_ps(_mm_sub_ps(minY, halfSizeY), originY), moveY);
+		__m128 farX = _mm_div_ps(_mm_sub_ps(_mm_add_ps(maxX, halfSizeX), originX), moveX);
+		__m128 farY = _mm_div_ps(_mm_sub_ps(_mm_add_ps(maxY, halfSizeY), originY), moveY);
+
+		__m128 hit = _mm_and_ps(_mm_cmpord_ps(nearX, nearY), _mm_cmpord_ps(farX, farY));
+
+		// if (near > far) swap
+		__m128 swapNearX = _mm_min_ps(farX, nearX);
+		farX = _mm_max_ps(nearX, farX);
+		nearX = swapNearX;
+		__m128 swapNearY = _mm_min_ps(farY, nearY);
+		farY = _mm_max_ps(nearY, farY);
+		nearY = swapNearY;
+
+		hit = _mm_andnot_ps(_mm_or_ps(_mm_cmpgt_ps(nearX, farY), _mm_cmpgt_ps(nearY, farX)), hit);
+
+		__m128 contactTime = _mm_max_ps(nearX, nearY);
+		__m128 tHitFar = _mm_min_ps(farX, farY);
+
+		hit = _mm_and_ps(hit, _mm_cmpge_ps(tHitFar, _mm_setzero_ps()));
+		hit = _mm_and_ps(hit, _mm_cmple_ps(contactTime, _mm_set1_ps(1.0f)));
+
+		_mm_storeu_ps(_outContactTimes, contactTime);
+
+		return _mm_movemask_ps(hit) & ~blockedMask;
+	}
+#endif
+#pragma endregion
+
 #pragma region Colliders
 	enum ColliderType { BOX };
 
+	// Colliders only meet when each one's category is in the other's mask
+	enum CollisionLayers : UINT32
+	{
+		COLLISION_LAYER_DEFAULT = 1 << 0,
+		COLLISION_LAYER_PLAYER = 1 << 1,
+		COLLISION_LAYER_ALL = 0xFFFFFFFF
+	};
+
+	// Reads a comma separated list of layer names (Default, Player, All) or raw bit masks
+	static UINT32 StringToCollisionLayers(const std::string& _layers)
+	{
+		UINT32 output = 0;
+		std::stringstream stream(_layers);
+		std::string layer;
+
+		while (std::getline(stream, layer, ','))
+		{
+			layer.erase(std::remove(layer.begin(), layer.end(), ' '), layer.end());
+
+			if (layer == "Default")
+				output |= COLLISION_LAYER_DEFAULT;
+			else if (layer == "Player")
+				output |= COLLISION_LAYER_PLAYER;
+			else if (layer == "All")
+				output |= COLLISION_LAYER_ALL;
+			else if (!layer.empty())
+			{
+				// A typo in the ini is logged and skipped rather than failing the config load
+				char* end = nullptr;
+				errno = 0;
+				unsigned long bits = std::strtoul(layer.c_str(), &end, 0);
+
+				if (end != layer.c_str() + layer.size() || errno == ERANGE || bits > 0xFFFFFFFFul || layer[0] == '-')
+					std::cout << "Unknown collision layer \"" << layer << "\" skipped" << std::endl;
+				else
+					output |= (UINT32)bits;
+			}
+		}
+
+		return output;
+	}
+
 	struct Collider
 	{
 		flecs::id ownerId;
@@ -133,20 +337,29 @@ namespace MAD
 		size_t id;
 		bool isTrigger;
 		bool isOneWay;
+		UINT32 category;
+		UINT32 mask;
 		GVECTORF localPos;
 		std::vector<Collider*> contacts;
 
-		Collider(ColliderType _type, size_t _id, bool _isTrigger, bool _isOneWay) : 
+		Collider(ColliderType _type, size_t _id, bool _isTrigger, bool _isOneWay, UINT32 _category, UINT32 _mask) : 
 			ownerId(flecs::id()), 
 			type(_type), 
 			id(_id), 
 			isTrigger(_isTrigger),
 			isOneWay(_isOneWay),
+			category(_category),
+			mask(_mask),
 			localPos({}), 
 			contacts({})
 		{}
 
 	public:
+		inline bool CanCollide(const Collider* _other) const
+		{
+			return (category & _other->mask) && (_other->category & mask);
+		}
+
 		bool IsContacting(Collider* _collider) const
 		{
 			for (Collider* contact : contacts)
@@ -180,20 +393,20 @@ namespace MAD
 			contacts.clear();
 		}
 
-		void DropCollidersContacts(std::vector<std::shared_ptr<Collider>>& _colliders)
+		void DropCollidersContacts(const std::vector<std::shared_ptr<Collider>>& _colliders)
 		{
-			std::vector<Collider*> contactsToDrop;
-			for (auto collider : _colliders)
-			{
-				for (auto contact = contacts.begin(); contact != contacts.end(); contact++)
-				{
-					if (collider.get() == *contact)
+			contacts.erase(
+				std::remove_if(contacts.begin(), contacts.end(),
+					[&_colliders](const Collider* _contact)
 					{
-						contacts.erase(contact);
-						break;
-					}
-				}
-			}
+						for (const auto& collider : _colliders)
+						{
+							if (collider.get() == _contact)
+								return true;
+						}
+						return false;
+					}),
+				contacts.end());
 		}
 
 		virtual GCollision::GCollisionCheck CollisionCheck(const Collider* _other) const = 0;
@@ -217,8 +430,14 @@ namespace MAD
 		GAABBMMF boundBox;
 		GVECTORF size;
 
-		BoxCollider(size_t _id, bool _isTrigger, bool _isOneWay, GAABBMMF _boundBox)
-			: boundBox(_boundBox), Collider(BOX, _id, _isTrigger, _isOneWay)
+		BoxCollider(
+			size_t _id, 
+			bool _isTrigger, 
+			bool _isOneWay, 
+			GAABBMMF _boundBox,
+			UINT32 _category = COLLISION_LAYER_DEFAULT,
+			UINT32 _mask = COLLISION_LAYER_ALL)
+			: boundBox(_boundBox), Collider(BOX, _id, _isTrigger, _isOneWay, _category, _mask)
 		{
 			size = {
 				boundBox.max.x - boundBox.min.x,
@@ -272,25 +491,15 @@ namespace MAD
 						return collisionCheck;
 				}
 
-				BoxCollider* box = (BoxCollider*)_other;
-				// The collider is expanded by half the width of our collider, so that our contact point
-				// is exactly where we need to end up to not enter the _other collider
-				GAABBMMF expandedBox = box->boundBox; 
-				GVector::SubtractVectorF(expandedBox.min, MultiplyVector(size, .5f), expandedBox.min);
-				GVector::AddVectorF(expandedBox.max, MultiplyVector(size, .5f), expandedBox.max);
-				Ray ray
-				{
-					GetGAABBMMFCenter(boundBox),
-					_amountToMove
-				};
+				const GAABBMMF& otherBox = ((BoxCollider*)_other)->boundBox;
+				GVECTORF center = GetGAABBMMFCenter(boundBox);
 
-				if (ray.RaycastBox2D(expandedBox, _hitResult))
-				{
-					// Time is how far along the ray it hit the box, 
-					// if it's greater than 1, with current velocity this will not hit the other collider.
-					if (_hitResult.contactTime <= 1.0f)
-						return GCollision::GCollisionCheck::COLLISION;
-				}
+				if (SweepBox2D(
+					center.x, center.y, size.x * .5f, size.y * .5f,
+					_amountToMove.x, _amountToMove.y,
+					otherBox.min.x, otherBox.min.y, otherBox.max.x, otherBox.max.y,
+					_hitResult))
+					return GCollision::GCollisionCheck::COLLISION;
 				break;
 			}
 			default:
@@ -339,48 +548,75 @@ namespace MAD
 	{
 		flecs::id ownerId;
 		bool isMoveable;
+		// Static terrain whose tiles are also in the scene's collision bitmaps
+		bool isTerrain;
 		GW::MATH::GVECTORF worldPos;
 		float maxColDist;
 		std::vector<std::shared_ptr<Collider>> colliders;
 		std::vector<std::shared_ptr<Collider>> triggerColliders;
 		std::vector<std::shared_ptr<Collider>> physicsColliders;
 		std::vector<ColliderContainer*> contacts;
+		// Every category / mask used by the container's colliders, to skip whole containers
+		UINT32 physicsCategories;
+		UINT32 physicsMasks;
+		UINT32 triggerMasks;
+		// Range of this container's physics colliders in the ColliderStore packed this step
+		UINT32 storeIndex;
+		UINT32 storeCount;
 
 #pragma region Constructors / Destructor
 		ColliderContainer()
 		{
 			ownerId = flecs::id();
 			isMoveable = false;
+			isTerrain = false;
 			worldPos = {};
 			maxColDist = 0;
 			colliders = {};
 			triggerColliders = {};
 			physicsColliders = {};
 			contacts = {};
+			physicsCategories = 0;
+			physicsMasks = 0;
+			triggerMasks = 0;
+			storeIndex = 0;
+			storeCount = 0;
 		}
 
 		ColliderContainer(bool _isMoveable)
 		{
 			ownerId = flecs::id();
 			isMoveable = _isMoveable;
+			isTerrain = false;
 			worldPos = {};
 			maxColDist = 0;
 			colliders = {};
 			triggerColliders = {};
 			physicsColliders = {};
 			contacts = {};
+			physicsCategories = 0;
+			physicsMasks = 0;
+			triggerMasks = 0;
+			storeIndex = 0;
+			storeCount = 0;
 		}
 
 		ColliderContainer(bool _isMoveable, std::string _iniName, std::weak_ptr<const GameConfig> _gameConfig)
 		{
 			ownerId = flecs::id();
 			isMoveable = _isMoveable;
+			isTerrain = false;
 			worldPos = {};
 			maxColDist = 0;
 			colliders = {};
 			triggerColliders = {};
 			physicsColliders = {};
 			contacts = {};
+			physicsCategories = 0;
+			physicsMasks = 0;
+			triggerMasks = 0;
+			storeIndex = 0;
+			storeCount = 0;
 
 			std::shared_ptr<const GameConfig> readCfg = _gameConfig.lock();
 			if (readCfg->find(_iniName.c_str()) == readCfg->end())
@@ -396,6 +632,8 @@ namespace MAD
 				GVECTORF pos = GZeroVectorF;
 				GVECTORF scale = { 1,1,1 };
 				GVECTORF collisionDir = GZeroVectorF;
+				UINT32 category = COLLISION_LAYER_DEFAULT;
+				UINT32 mask = COLLISION_LAYER_ALL;
 
 				if (readCfg->at(_iniName.c_str()).find("boxCol" + iStr + "IsOneWay") != readCfg->at(_iniName.c_str()).end())
 					isOneWay = readCfg->at(_iniName.c_str()).at("boxCol" + iStr + "IsOneWay").as<bool>();
@@ -409,7 +647,13 @@ namespace MAD
 				if (readCfg->at(_iniName.c_str()).find("boxCol" + iStr + "ColDir") != readCfg->at(_iniName.c_str()).end())
 					collisionDir = StringToGVector(readCfg->at(_iniName.c_str()).at("boxCol" + iStr + "ColDir").as<std::string>());
 
-				AddBoxCollider(isTrigger, isOneWay, pos, scale, collisionDir);
+				if (readCfg->at(_iniName.c_str()).find("boxCol" + iStr + "Category") != readCfg->at(_iniName.c_str()).end())
+					category = StringToCollisionLayers(readCfg->at(_iniName.c_str()).at("boxCol" + iStr + "Category").as<std::string>());
+
+				if (readCfg->at(_iniName.c_str()).find("boxCol" + iStr + "Mask") != readCfg->at(_iniName.c_str()).end())
+					mask = StringToCollisionLayers(readCfg->at(_iniName.c_str()).at("boxCol" + iStr + "Mask").as<std::string>());
+
+				AddBoxCollider(isTrigger, isOneWay, pos, scale, collisionDir, category, mask);
 				iStr = std::to_string(++i);
 			}
 		}
@@ -418,14 +662,20 @@ namespace MAD
 		{
 			ownerId = _ownerId;
 			isMoveable = _other.isMoveable;
+			isTerrain = _other.isTerrain;
 			worldPos = _worldPosition;
 			maxColDist = _other.maxColDist;
 			colliders = {};
 			triggerColliders = {};
 			physicsColliders = {};
 			contacts = {};
+			physicsCategories = 0;
+			physicsMasks = 0;
+			triggerMasks = 0;
+			storeIndex = 0;
+			storeCount = 0;
 
-			for (auto collider : _other.colliders)
+			for (const auto& collider : _other.colliders)
 			{
 				CopyCollider(collider.get());
 			}
@@ -433,15 +683,16 @@ namespace MAD
 			UpdateWorldPosition(_worldPosition);
 		}
 
-		~ColliderContainer()
-		{
-			triggerColliders.clear();
-			physicsColliders.clear();
-			for (std::shared_ptr<Collider> collider : colliders)
-			{
-				collider.reset();
-			}
-		}
+		// Copies share the same colliders, and contacts point at containers where flecs stores them.
+		// Update the stored container in place instead of copying it out and setting it back.
+		ColliderContainer(const ColliderContainer& _other) = default;
+		ColliderContainer& operator=(const ColliderContainer& _other) = default;
+
+		// flecs moves components when entities change archetype
+		ColliderContainer(ColliderContainer&& _other) noexcept = default;
+		ColliderContainer& operator=(ColliderContainer&& _other) noexcept = default;
+
+		~ColliderContainer() = default;
 #pragma endregion
 
 		inline bool InCollisionRange(const ColliderContainer& _other) const
@@ -449,11 +700,18 @@ namespace MAD
 			return Distance2D(worldPos, _other.worldPos) < maxColDist + _other.maxColDist;
 		}
 
+		// Square around worldPos that holds the whole collision range, used for broadphase binning
+		inline void GetRangeBounds(GVECTORF& _outMin, GVECTORF& _outMax) const
+		{
+			_outMin = { worldPos.x - maxColDist, worldPos.y - maxColDist };
+			_outMax = { worldPos.x + maxColDist, worldPos.y + maxColDist };
+		}
+
 		void UpdateWorldPosition(const GVECTORF& _worldPos)
 		{
 			worldPos = _worldPos;
 
-			for (auto collider : colliders)
+			for (const auto& collider : colliders)
 			{
 				collider->UpdateWorldPosition(_worldPos);
 			}
@@ -464,7 +722,9 @@ namespace MAD
 			bool _isOneWay,
 			const GVECTORF& _localPos, 
 			const GVECTORF& _scale, 
-			const GVECTORF& _collisionDir = GZeroVectorF)
+			const GVECTORF& _collisionDir = GZeroVectorF,
+			UINT32 _category = COLLISION_LAYER_DEFAULT,
+			UINT32 _mask = COLLISION_LAYER_ALL)
 		{
 			GVECTORF halfScale = MultiplyVector(_scale, .5f);
 			GVECTORF min;
@@ -478,7 +738,7 @@ namespace MAD
 				max
 			};
 
-			std::shared_ptr<BoxCollider> collider = std::make_shared<BoxCollider>(colliders.size(), _isTrigger, _isOneWay, boundBox);
+			std::shared_ptr<BoxCollider> collider = std::make_shared<BoxCollider>(colliders.size(), _isTrigger, _isOneWay, boundBox, _category, _mask);
 			collider->localPos = _localPos;
 
 			colliders.push_back(collider);
@@ -488,6 +748,8 @@ namespace MAD
 			else
 				physicsColliders.push_back(colliders[colliders.size() - 1]);
 
+			AddLayers(collider.get());
+
 			UpdateMaxColDist();
 		}
 
@@ -497,6 +759,7 @@ namespace MAD
 				contacts.push_back(_colliders);
 		}
 
+		// Collider level contacts are left to the physics step's ContactPairCache
 		void ExitContacts(ColliderContainer* _colliders)
 		{
 			for (auto contact = contacts.begin(); contact != contacts.end(); contact ++)
@@ -509,11 +772,6 @@ namespace MAD
 					break;
 				}
 			}
-
-			for (auto collider : colliders)
-			{
-				collider->DropCollidersContacts(_colliders->colliders);
-			}
 		}
 
 		void DropAllContacts()
@@ -521,10 +779,14 @@ namespace MAD
 			for (auto contact : contacts)
 			{
 				contact->ExitContacts(this);
+				for (const auto& collider : contact->colliders)
+				{
+					collider->DropCollidersContacts(colliders);
+				}
 			}
 			contacts.clear();
 
-			for (auto collider : colliders)
+			for (const auto& collider : colliders)
 			{
 				collider->DropAllContacts();
 			}
@@ -556,7 +818,9 @@ namespace MAD
 					colliders.size(), 
 					collider->isTrigger, 
 					collider->isOneWay,
-					((BoxCollider*)collider)->boundBox);
+					((BoxCollider*)collider)->boundBox,
+					collider->category,
+					collider->mask);
 				break;
 			}
 			default:
@@ -571,6 +835,21 @@ namespace MAD
 				triggerColliders.push_back(colliderCopy);
 			else
 				physicsColliders.push_back(colliderCopy);
+
+			AddLayers(colliderCopy.get());
+		}
+
+		void AddLayers(const Collider* _collider)
+		{
+			if (_collider->isTrigger)
+			{
+				triggerMasks |= _collider->mask;
+			}
+			else
+			{
+				physicsCategories |= _collider->category;
+				physicsMasks |= _collider->mask;
+			}
 		}
 
 		void UpdateMaxColDist()
@@ -579,7 +858,7 @@ namespace MAD
 
 			GVECTORF sumPos;
 			float tempDist;
-			for (auto collider : colliders)
+			for (const auto& collider : colliders)
 			{
 				GVector::AddVectorF(collider->localPos, collider->GetExtent(), sumPos);
 				tempDist = Distance2D(GIdentityVectorF, sumPos);
@@ -589,6 +868,359 @@ namespace MAD
 		}
 	};
 #pragma endregion
+
+#pragma region Collider Store
+	enum ColliderFlags : UINT32
+	{
+		COLLIDER_ONE_WAY = 1 << 0,
+		COLLIDER_MOVEABLE = 1 << 1,
+		// Terrain that is also in its scene's tile bitmaps
+		COLLIDER_TERRAIN = 1 << 2
+	};
+
+	// Structure of arrays copy of physics box colliders, so collision passes walk contiguous
+	// floats instead of shared_ptrs and virtual calls. Containers point at their range through
+	// storeIndex / storeCount. Indices are only valid until the next Clear / Truncate, and the 
+	// arrays keep their capacity so refilling them every step doesn't allocate.
+	struct ColliderStore
+	{
+		std::vector<float> minX;
+		std::vector<float> minY;
+		std::vector<float> maxX;
+		std::vector<float> maxY;
+		std::vector<float> halfSizeX;
+		std::vector<float> halfSizeY;
+		std::vector<flecs::entity_t> ownerIds;
+		std::vector<UINT32> flags;
+		std::vector<UINT32> categories;
+		std::vector<UINT32> masks;
+		// Kept so contacts can still be entered on the colliders themselves
+		std::vector<Collider*> colliders;
+
+		inline UINT32 Size() const
+		{
+			return (UINT32)ownerIds.size();
+		}
+
+		void Clear()
+		{
+			Truncate(0);
+		}
+
+		void Truncate(UINT32 _size)
+		{
+			minX.resize(_size);
+			minY.resize(_size);
+			maxX.resize(_size);
+			maxY.resize(_size);
+			halfSizeX.resize(_size);
+			halfSizeY.resize(_size);
+			ownerIds.resize(_size);
+			flags.resize(_size);
+			categories.resize(_size);
+			masks.resize(_size);
+			colliders.resize(_size);
+		}
+
+		// Packs the container's physics colliders and points the container at them
+		void AddContainer(ColliderContainer& _colliders)
+		{
+			_colliders.storeIndex = Size();
+
+			for (const auto& collider : _colliders.physicsColliders)
+			{
+				if (collider->type != BOX)
+					continue;
+
+				const BoxCollider* box = (const BoxCollider*)collider.get();
+				AddBox(
+					box->boundBox.min.x, box->boundBox.min.y, box->boundBox.max.x, box->boundBox.max.y,
+					(box->isOneWay ? COLLIDER_ONE_WAY : 0) |
+					(_colliders.isMoveable ? COLLIDER_MOVEABLE : 0) |
+					(_colliders.isTerrain ? COLLIDER_TERRAIN : 0),
+					_colliders.ownerId, box->category, box->mask, collider.get());
+			}
+
+			_colliders.storeCount = Size() - _colliders.storeIndex;
+		}
+
+		// Packs a box that may not belong to any collider, returns its index
+		UINT32 AddBox(
+			float _minX, float _minY, float _maxX, float _maxY,
+			UINT32 _flags,
+			flecs::entity_t _ownerId = 0,
+			UINT32 _category = COLLISION_LAYER_DEFAULT,
+			UINT32 _mask = COLLISION_LAYER_ALL,
+			Collider* _collider = nullptr)
+		{
+			minX.push_back(_minX);
+			minY.push_back(_minY);
+			maxX.push_back(_maxX);
+			maxY.push_back(_maxY);
+			halfSizeX.push_back((_maxX - _minX) * .5f);
+			halfSizeY.push_back((_maxY - _minY) * .5f);
+			ownerIds.push_back(_ownerId);
+			flags.push_back(_flags);
+			categories.push_back(_category);
+			masks.push_back(_mask);
+			colliders.push_back(_collider);
+
+			return Size() - 1;
+		}
+
+		inline bool CanCollide(UINT32 _index, UINT32 _otherIndex) const
+		{
+			return (categories[_index] & masks[_otherIndex]) && (categories[_otherIndex] & masks[_index]);
+		}
+
+		inline bool CollisionCheck(UINT32 _index, UINT32 _otherIndex) const
+		{
+			return TestBoxOverlap2D(
+				minX[_index], minY[_index], maxX[_index], maxY[_index],
+				minX[_otherIndex], minY[_otherIndex], maxX[_otherIndex], maxY[_otherIndex]);
+		}
+
+		// Same rules as BoxCollider::DynamicCollisionCheck2D
+		inline bool DynamicCollisionCheck2D(
+			UINT32 _index, 
+			UINT32 _otherIndex, 
+			const GVECTORF& _amountToMove, 
+			RaycastHit& _hitResult) const
+		{
+			if (_amountToMove.x == 0 && _amountToMove.y == 0)
+				return false;
+
+			if (flags[_otherIndex] & COLLIDER_ONE_WAY)
+			{
+				if (_amountToMove.y >= 0)
+					return false;
+				else if (CollisionCheck(_index, _otherIndex))
+					return false;
+			}
+
+			return SweepBox2D(
+				minX[_index] + .5f * (maxX[_index] - minX[_index]),
+				minY[_index] + .5f * (maxY[_index] - minY[_index]),
+				halfSizeX[_index], halfSizeY[_index],
+				_amountToMove.x, _amountToMove.y,
+				minX[_otherIndex], minY[_otherIndex], maxX[_otherIndex], maxY[_otherIndex],
+				_hitResult);
+		}
+
+		// DynamicCollisionCheck2D against up to 4 entries at once, for the broadphase's inner loop.
+		// Returns a mask of the lanes that hit, see SweepBoxes2D4.
+		inline int DynamicCollisionCheck2D4(
+			UINT32 _index,
+			const UINT32* _otherIndices,
+			UINT32 _otherCount,
+			const GVECTORF& _amountToMove,
+			float* _outContactTimes) const
+		{
+			UINT32 laneCount = min(_otherCount, 4u);
+#ifdef MAD_SWEEP_SSE
+			float laneMinX[4], laneMinY[4], laneMaxX[4], laneMaxY[4];
+			int oneWayMask = 0;
+
+			for (UINT32 lane = 0; lane < 4; lane++)
+			{
+				// Unused lanes repeat the first entry and are masked off below
+				UINT32 other = _otherIndices[lane < laneCount ? lane : 0];
+				laneMinX[lane] = minX[other];
+				laneMinY[lane] = minY[other];
+				laneMaxX[lane] = maxX[other];
+				laneMaxY[lane] = maxY[other];
+				if (flags[other] & COLLIDER_ONE_WAY)
+					oneWayMask |= 1 << lane;
+			}
+
+			int hitMask = SweepBoxes2D4(
+				minX[_index], minY[_index], maxX[_index], maxY[_index],
+				halfSizeX[_index], halfSizeY[_index],
+				_amountToMove.x, _amountToMove.y,
+				laneMinX, laneMinY, laneMaxX, laneMaxY,
+				oneWayMask,
+				_outContactTimes);
+
+			return hitMask & ((1 << laneCount) - 1);
+#else
+			int hitMask = 0;
+			RaycastHit hitResult;
+
+			for (UINT32 lane = 0; lane < laneCount; lane++)
+			{
+				if (!DynamicCollisionCheck2D(_index, _otherIndices[lane], _amountToMove, hitResult))
+					continue;
+
+				hitMask |= 1 << lane;
+				_outContactTimes[lane] = hitResult.contactTime;
+			}
+
+			return hitMask;
+#endif
+		}
+	};
+#pragma endregion
+
+#pragma region Contacts
+	// A trigger collider overlapping a physics collider
+	struct ContactPair
+	{
+		Collider* trigger;
+		Collider* other;
+		flecs::entity_t triggerOwnerId;
+		flecs::entity_t otherOwnerId;
+	};
+
+	// Singleton holding the contact changes of the last physics step.
+	// step increases every time the arrays are refilled, so consumers can skip steps they've already handled.
+	struct ContactEvents
+	{
+		UINT64 step;
+		std::vector<ContactPair> entered;
+		std::vector<ContactPair> stayed;
+		std::vector<ContactPair> exited;
+	};
+
+	// Open addressing (linear probing) table of contact pairs, stamped with the step they were last touched in.
+	// The trigger pass only calls Touch, Resolve then turns the stamps into enter / stay / exit events.
+	class ContactPairCache
+	{
+		enum SlotState : UCHAR { EMPTY, OCCUPIED, REMOVED };
+
+		struct Slot
+		{
+			ContactPair pair;
+			UINT64 touchedStep;
+			UINT64 enteredStep;
+			SlotState state;
+		};
+
+		std::vector<Slot> slots;
+		UINT32 occupiedCount;
+		UINT32 removedCount;
+		UINT64 step;
+
+	public:
+		ContactPairCache()
+		{
+			occupiedCount = 0;
+			removedCount = 0;
+			step = 1;
+			slots.resize(64, { {}, 0, 0, EMPTY });
+		}
+
+		UINT64 GetStep() const
+		{
+			return step;
+		}
+
+		void Touch(Collider* _trigger, Collider* _other, flecs::entity_t _triggerOwnerId, flecs::entity_t _otherOwnerId)
+		{
+			// Keep at most 70% of the slots in use so probes stay short
+			if ((occupiedCount + removedCount + 1) * 10 > slots.size() * 7)
+				Rehash(occupiedCount * 4 >= slots.size() ? slots.size() * 2 : slots.size());
+
+			size_t mask = slots.size() - 1;
+			size_t index = Hash(_trigger, _other) & mask;
+			size_t firstRemoved = SIZE_MAX;
+
+			while (slots[index].state != EMPTY)
+			{
+				Slot& slot = slots[index];
+				if (slot.state == OCCUPIED && slot.pair.trigger == _trigger && slot.pair.other == _other)
+				{
+					slot.touchedStep = step;
+					return;
+				}
+				if (slot.state == REMOVED && firstRemoved == SIZE_MAX)
+					firstRemoved = index;
+
+				index = (index + 1) & mask;
+			}
+
+			if (firstRemoved != SIZE_MAX)
+			{
+				index = firstRemoved;
+				removedCount--;
+			}
+
+			slots[index] = { { _trigger, _other, _triggerOwnerId, _otherOwnerId }, step, step, OCCUPIED };
+			occupiedCount++;
+		}
+
+		// Fills the event arrays with every pair's change since the last Resolve and starts the next step
+		void Resolve(ContactEvents& _events)
+		{
+			_events.entered.clear();
+			_events.stayed.clear();
+			_events.exited.clear();
+
+			for (Slot& slot : slots)
+			{
+				if (slot.state != OCCUPIED)
+					continue;
+
+				if (slot.touchedStep != step)
+				{
+					_events.exited.push_back(slot.pair);
+					slot.state = REMOVED;
+					occupiedCount--;
+					removedCount++;
+				}
+				else if (slot.enteredStep == step)
+					_events.entered.push_back(slot.pair);
+				else
+					_events.stayed.push_back(slot.pair);
+			}
+
+			_events.step = step++;
+		}
+
+		// Forgets every pair of _ownerId without raising events, for colliders that are about to be freed
+		void RemoveOwner(flecs::entity_t _ownerId)
+		{
+			for (Slot& slot : slots)
+			{
+				if (slot.state == OCCUPIED &&
+					(slot.pair.triggerOwnerId == _ownerId || slot.pair.otherOwnerId == _ownerId))
+				{
+					slot.state = REMOVED;
+					occupiedCount--;
+					removedCount++;
+				}
+			}
+		}
+
+	private:
+		static inline size_t Hash(const Collider* _trigger, const Collider* _other)
+		{
+			UINT64 hash = (UINT64)(uintptr_t)_trigger * 0x9E3779B97F4A7C15ull;
+			hash ^= (UINT64)(uintptr_t)_other + 0x632BE59BD9B4E019ull + (hash << 6) + (hash >> 2);
+			hash ^= hash >> 29;
+			return (size_t)hash;
+		}
+
+		void Rehash(size_t _size)
+		{
+			std::vector<Slot> oldSlots;
+			oldSlots.swap(slots);
+			slots.resize(_size, { {}, 0, 0, EMPTY });
+			removedCount = 0;
+
+			size_t mask = slots.size() - 1;
+			for (const Slot& slot : oldSlots)
+			{
+				if (slot.state != OCCUPIED)
+					continue;
+
+				size_t index = Hash(slot.pair.trigger, slot.pair.other) & mask;
+				while (slots[index].state != EMPTY)
+					index = (index + 1) & mask;
+				slots[index] = slot;
+			}
+		}
+	};
+#pragma endregion
 };
 
 #endif
\ No newline at end of file
@@ -1,6 +1,10 @@
 #ifndef TILEMAPS_H
 #define TILEMAPS_H
 
+#include <cmath>
+#include <functional>
+#include <algorithm>
+
 #include "Tiles.h"
 
 namespace MAD
@@ -21,6 +25,31 @@ namespace MAD
 			tilesetId = _tilesetId;
 			orientationId = _orientationId;
 		}
+
+		bool operator==(const TilemapTile& _other) const
+		{
+			return tilesetId == _other.tilesetId && orientationId == _other.orientationId;
+		}
+	};
+
+	// A square block of a Tilemap's tiles. While every tile in it is the same it's stored as that one tile,
+	// once they differ its tiles live in the tilemap's dense buffer starting at denseOffset.
+	struct TileChunk
+	{
+		static constexpr UINT32 NOT_DENSE = 0xFFFFFFFF;
+
+		TilemapTile uniformTile = { 0, 0 };
+		UINT32 denseOffset = NOT_DENSE;
+
+		bool IsDense() const
+		{
+			return denseOffset != NOT_DENSE;
+		}
+
+		bool IsEmpty() const
+		{
+			return !IsDense() && uniformTile.tilesetId == 0;
+		}
 	};
 
 	struct CompressedTile
@@ -56,6 +85,69 @@ namespace MAD
 		}
 	};
 
+	enum TileCollision : UCHAR
+	{
+		TILE_COLLISION_NONE,
+		// Fills the whole cell
+		TILE_COLLISION_SOLID,
+		// Only landed on from above, its surface is the top of the cell
+		TILE_COLLISION_ONE_WAY
+	};
+
+	// One bit per tile, each row packed into 64 bit words
+	struct TileBitmap
+	{
+		UINT32 rows = 0;
+		UINT32 columns = 0;
+		UINT32 wordsPerRow = 0;
+		std::vector<UINT64> words;
+
+		void Resize(UINT32 _rows, UINT32 _columns)
+		{
+			rows = _rows;
+			columns = _columns;
+			wordsPerRow = (_columns + 63) / 64;
+			words.assign((size_t)rows * wordsPerRow, 0);
+		}
+
+		inline bool Get(UINT32 _row, UINT32 _col) const
+		{
+			return (words[(size_t)_row * wordsPerRow + _col / 64] >> (_col % 64)) & 1;
+		}
+
+		inline void Set(UINT32 _row, UINT32 _col, bool _value)
+		{
+			UINT64& word = words[(size_t)_row * wordsPerRow + _col / 64];
+			UINT64 bit = (UINT64)1 << (_col % 64);
+			word = _value ? (word | bit) : (word & ~bit);
+		}
+
+		// Calls _onCell(row, col) for every set bit in [_minRow, _maxRow] x [_minCol, _maxCol], skipping empty words
+		template <typename F>
+		void ForEachSet(UINT32 _minRow, UINT32 _minCol, UINT32 _maxRow, UINT32 _maxCol, const F& _onCell) const
+		{
+			for (UINT32 row = _minRow; row <= _maxRow; row++)
+			{
+				const UINT64* rowWords = &words[(size_t)row * wordsPerRow];
+
+				for (UINT32 wordIndex = _minCol / 64; wordIndex <= _maxCol / 64; wordIndex++)
+				{
+					UINT64 word = rowWords[wordIndex];
+					if (wordIndex == _minCol / 64)
+						word &= ~(UINT64)0 << (_minCol % 64);
+					if (wordIndex == _maxCol / 64 && _maxCol % 64 != 63)
+						word &= ((UINT64)1 << (_maxCol % 64 + 1)) - 1;
+
+					for (UINT32 bit = 0; word != 0; bit++, word >>= 1)
+					{
+						if (word & 1)
+							_onCell(row, wordIndex * 64 + bit);
+					}
+				}
+			}
+		}
+	};
+
 	struct Tilemap
 	{
 		INT32 originX;
@@ -63,8 +155,22 @@ namespace MAD
 		UINT32 rows;
 		UINT32 columns;
 		std::vector<USHORT> neighborScenes;
-		std::vector<std::vector<TilemapTile>> tiles;
 		std::vector<Spawnpoint> spawnpoints;
+		// Tiles are split into CHUNK_SIZE x CHUNK_SIZE chunks, row major. Empty and uniform chunks take no tile memory,
+		// dense ones own CHUNK_AREA consecutive tiles of denseTiles, row major within the chunk.
+		static constexpr UINT32 CHUNK_SIZE = 16;
+		static constexpr UINT32 CHUNK_AREA = CHUNK_SIZE * CHUNK_SIZE;
+		UINT32 chunkRows;
+		UINT32 chunkColumns;
+		std::vector<TileChunk> chunks;
+		std::vector<TilemapTile> denseTiles;
+		// Chunks changed through SetTile since ClearDirtyChunks, in the order they were first changed.
+		// FillRow is for loading so it doesn't mark chunks.
+		std::vector<UINT32> dirtyChunks;
+		std::vector<bool> isChunkDirty;
+		// Terrain physics reads these instead of per tile colliders, see BuildCollisionBitmaps
+		TileBitmap solidTiles;
+		TileBitmap oneWayTiles;
 
 		Tilemap() 
 		{
@@ -72,7 +178,8 @@ namespace MAD
 			originY = 0;
 			rows = 0;
 			columns = 0;
-			tiles = {};
+			chunkRows = 0;
+			chunkColumns = 0;
 		};
 
 		Tilemap(INT32 _originX, INT32 _originY, UINT32 _rows, UINT32 _columns)
@@ -82,11 +189,10 @@ namespace MAD
 			rows = _rows;
 			columns = _columns;
 
-			tiles.resize(rows);
-			for (UINT32 row = 0; row < rows; row++)
-			{
-				tiles[row] = std::vector<TilemapTile>(columns, TilemapTile({0, 0}));
-			}
+			chunkRows = (rows + CHUNK_SIZE - 1) / CHUNK_SIZE;
+			chunkColumns = (columns + CHUNK_SIZE - 1) / CHUNK_SIZE;
+			chunks.assign((size_t)chunkRows * chunkColumns, TileChunk());
+			isChunkDirty.assign(chunks.size(), false);
 		}
 
 		void AddSpawnpoint(GW::MATH::GVECTORF _worldPos, USHORT _otherSceneIndex)
@@ -115,34 +221,240 @@ namespace MAD
 				spawnpoints.end());
 		}
 
-		TilemapTile* GetTile(int _row, int _col)
+		// Tiles are written through SetTile and FillRow, a uniform chunk's tile is shared by all of its cells
+		const TilemapTile* GetTile(int _row, int _col) const
 		{
 			if (_row >= 0 && _row < rows && _col >= 0 && _col < columns)
-				return &tiles[_row][_col];
+				return &GetTileAt(_row, _col);
 
 			return NULL;
 		}
 
-		TilemapTile* GetTile(GW::MATH::GVECTORF _worldPos)
+		const TilemapTile* GetTile(GW::MATH::GVECTORF _worldPos) const
 		{
 			int row = _worldPos.y - originY;
 			int col = _worldPos.x - originX;
 
 			if (row >= 0 && row < rows && col >= 0 && col < columns)
-				return &tiles[row][col];
+				return &GetTileAt(row, col);
 
 			return NULL;
 		}
 
-		TilemapTile* GetTile(const Tile& _tile)
+		const TilemapTile* GetTile(const Tile& _tile) const
 		{
 			if (_tile.sceneRow >= 0 && _tile.sceneRow < rows && 
 				_tile.sceneCol >= 0 && _tile.sceneCol < columns)
-				return &tiles[_tile.sceneRow][_tile.sceneCol];
+				return &GetTileAt(_tile.sceneRow, _tile.sceneCol);
 
 			return NULL;
 		}
 
+		// Unchecked, _row and _col must be inside the tilemap
+		inline const TilemapTile& GetTileAt(UINT32 _row, UINT32 _col) const
+		{
+			const TileChunk& chunk = chunks[(size_t)(_row / CHUNK_SIZE) * chunkColumns + _col / CHUNK_SIZE];
+			if (!chunk.IsDense())
+				return chunk.uniformTile;
+
+			return denseTiles[chunk.denseOffset + (_row % CHUNK_SIZE) * CHUNK_SIZE + _col % CHUNK_SIZE];
+		}
+
+		// _tile is taken by value, it may be a tile of this tilemap that making its chunk dense would move
+		void SetTile(UINT32 _row, UINT32 _col, TilemapTile _tile)
+		{
+			if (_row >= rows || _col >= columns)
+				return;
+
+			UINT32 chunkIndex = (_row / CHUNK_SIZE) * chunkColumns + _col / CHUNK_SIZE;
+			TileChunk& chunk = chunks[chunkIndex];
+			if (!chunk.IsDense())
+			{
+				if (chunk.uniformTile == _tile)
+					return;
+				MakeChunkDense(chunk);
+			}
+
+			denseTiles[chunk.denseOffset + (_row % CHUNK_SIZE) * CHUNK_SIZE + _col % CHUNK_SIZE] = _tile;
+
+			if (!isChunkDirty[chunkIndex])
+			{
+				isChunkDirty[chunkIndex] = true;
+				dirtyChunks.push_back(chunkIndex);
+			}
+		}
+
+		void ClearDirtyChunks()
+		{
+			for (UINT32 chunkIndex : dirtyChunks)
+				isChunkDirty[chunkIndex] = false;
+			dirtyChunks.clear();
+		}
+
+		// The first row and column of a chunk and how many of its rows and columns are inside the tilemap
+		void GetChunkBounds(UINT32 _chunkIndex, UINT32& _outRow, UINT32& _outCol, UINT32& _outRows, UINT32& _outColumns) const
+		{
+			_outRow = (_chunkIndex / chunkColumns) * CHUNK_SIZE;
+			_outCol = (_chunkIndex % chunkColumns) * CHUNK_SIZE;
+			_outRows = min(CHUNK_SIZE, rows - _outRow);
+			_outColumns = min(CHUNK_SIZE, columns - _outCol);
+		}
+
+		// Sets _count tiles along _row starting at _col, which must all be inside the tilemap.
+		// Chunks that already hold only _tile are left uniform.
+		void FillRow(UINT32 _row, UINT32 _col, UINT32 _count, TilemapTile _tile)
+		{
+			while (_count > 0)
+			{
+				TileChunk& chunk = chunks[(size_t)(_row / CHUNK_SIZE) * chunkColumns + _col / CHUNK_SIZE];
+				UINT32 chunkCol = _col % CHUNK_SIZE;
+				UINT32 spanLength = min(_count, CHUNK_SIZE - chunkCol);
+
+				if (chunk.IsDense() || !(chunk.uniformTile == _tile))
+				{
+					MakeChunkDense(chunk);
+					std::fill_n(denseTiles.begin() + chunk.denseOffset + (_row % CHUNK_SIZE) * CHUNK_SIZE + chunkCol, spanLength, _tile);
+				}
+
+				_col += spanLength;
+				_count -= spanLength;
+			}
+		}
+
+		// Turns dense chunks whose tiles all match back into uniform ones and packs the remaining dense tiles together.
+		// Chunks are packed in the order their tiles are laid out, so each only moves down and it's done in place.
+		void CompactChunks()
+		{
+			std::vector<UINT32> denseChunks;
+			for (UINT32 chunkIndex = 0; chunkIndex < chunks.size(); chunkIndex++)
+			{
+				if (chunks[chunkIndex].IsDense())
+					denseChunks.push_back(chunkIndex);
+			}
+
+			std::sort(denseChunks.begin(), denseChunks.end(), [this](UINT32 _a, UINT32 _b)
+				{
+					return chunks[_a].denseOffset < chunks[_b].denseOffset;
+				});
+
+			UINT32 compactedSize = 0;
+			for (UINT32 chunkIndex : denseChunks)
+			{
+				TileChunk& chunk = chunks[chunkIndex];
+
+				// Cells past the tilemap's edge are never written, so only the ones inside it are compared
+				UINT32 minRow, minCol, usedRows, usedColumns;
+				GetChunkBounds(chunkIndex, minRow, minCol, usedRows, usedColumns);
+				const TilemapTile* chunkTiles = &denseTiles[chunk.denseOffset];
+				bool isUniform = true;
+
+				for (UINT32 row = 0; row < usedRows && isUniform; row++)
+				{
+					for (UINT32 col = 0; col < usedColumns && isUniform; col++)
+						isUniform = chunkTiles[row * CHUNK_SIZE + col] == chunkTiles[0];
+				}
+
+				if (isUniform)
+				{
+					chunk.uniformTile = chunkTiles[0];
+					chunk.denseOffset = TileChunk::NOT_DENSE;
+				}
+				else
+				{
+					if (chunk.denseOffset != compactedSize)
+						std::copy(chunkTiles, chunkTiles + CHUNK_AREA, denseTiles.begin() + compactedSize);
+					chunk.denseOffset = compactedSize;
+					compactedSize += CHUNK_AREA;
+				}
+			}
+
+			denseTiles.erase(denseTiles.begin() + compactedSize, denseTiles.end());
+		}
+
+		// Calls _onTile(row, col, tile) for every non empty tile a chunk at a time, empty chunks are skipped whole
+		template <typename F>
+		void ForEachTile(const F& _onTile) const
+		{
+			for (UINT32 chunkRow = 0; chunkRow < chunkRows; chunkRow++)
+			{
+				for (UINT32 chunkCol = 0; chunkCol < chunkColumns; chunkCol++)
+				{
+					const TileChunk& chunk = chunks[(size_t)chunkRow * chunkColumns + chunkCol];
+					if (chunk.IsEmpty())
+						continue;
+
+					UINT32 minRow = chunkRow * CHUNK_SIZE;
+					UINT32 minCol = chunkCol * CHUNK_SIZE;
+					UINT32 maxRow = min(minRow + CHUNK_SIZE, rows);
+					UINT32 maxCol = min(minCol + CHUNK_SIZE, columns);
+
+					for (UINT32 row = minRow; row < maxRow; row++)
+					{
+						const TilemapTile* rowTiles = chunk.IsDense() ? &denseTiles[chunk.denseOffset + (row - minRow) * CHUNK_SIZE] : nullptr;
+
+						for (UINT32 col = minCol; col < maxCol; col++)
+						{
+							const TilemapTile& tile = rowTiles != nullptr ? rowTiles[col - minCol] : chunk.uniformTile;
+							if (tile.tilesetId != 0)
+								_onTile(row, col, tile);
+						}
+					}
+				}
+			}
+		}
+
+		// Calls _onSpan(col, count, tiles, stride) for each chunk's part of _row in column order.
+		// Uniform chunks pass their one tile with a stride of 0, dense ones their tiles with a stride of 1.
+		template <typename F>
+		void ForEachRowSpan(UINT32 _row, const F& _onSpan) const
+		{
+			const TileChunk* rowChunks = chunks.data() + (size_t)(_row / CHUNK_SIZE) * chunkColumns;
+
+			for (UINT32 chunkCol = 0; chunkCol < chunkColumns; chunkCol++)
+			{
+				const TileChunk& chunk = rowChunks[chunkCol];
+				UINT32 col = chunkCol * CHUNK_SIZE;
+				UINT32 spanLength = min(CHUNK_SIZE, columns - col);
+
+				if (chunk.IsDense())
+					_onSpan(col, spanLength, &denseTiles[chunk.denseOffset + (_row % CHUNK_SIZE) * CHUNK_SIZE], 1u);
+				else
+					_onSpan(col, spanLength, &chunk.uniformTile, 0u);
+			}
+		}
+
+		// Whether any tile passes _predicate, uniform chunks are only tested once
+		template <typename F>
+		bool AnyTile(const F& _predicate) const
+		{
+			for (UINT32 chunkRow = 0; chunkRow < chunkRows; chunkRow++)
+			{
+				for (UINT32 chunkCol = 0; chunkCol < chunkColumns; chunkCol++)
+				{
+					const TileChunk& chunk = chunks[(size_t)chunkRow * chunkColumns + chunkCol];
+					if (!chunk.IsDense())
+					{
+						if (_predicate(chunk.uniformTile))
+							return true;
+						continue;
+					}
+
+					UINT32 usedRows = min(CHUNK_SIZE, rows - chunkRow * CHUNK_SIZE);
+					UINT32 usedColumns = min(CHUNK_SIZE, columns - chunkCol * CHUNK_SIZE);
+					for (UINT32 row = 0; row < usedRows; row++)
+					{
+						for (UINT32 col = 0; col < usedColumns; col++)
+						{
+							if (_predicate(denseTiles[chunk.denseOffset + row * CHUNK_SIZE + col]))
+								return true;
+						}
+					}
+				}
+			}
+
+			return false;
+		}
+
 		GW::MATH::GVECTORF GetMinCorner()
 		{
 			return { (float)originX, (float)originY };
@@ -169,6 +481,55 @@ namespace MAD
 			return (sizeof(INT32) * 2) + (sizeof(UINT32) * 2);
 		}
 
+		void BuildCollisionBitmaps(const std::function<TileCollision(const TilemapTile&)>& _getTileCollision)
+		{
+			solidTiles.Resize(rows, columns);
+			oneWayTiles.Resize(rows, columns);
+
+			// Empty tiles never collide and the bitmaps start cleared
+			ForEachTile([&](UINT32 _row, UINT32 _col, const TilemapTile& _tile)
+				{
+					SetTileCollision(_row, _col, _getTileCollision(_tile));
+				});
+		}
+
+		void SetTileCollision(UINT32 _row, UINT32 _col, TileCollision _collision)
+		{
+			if (_row >= solidTiles.rows || _col >= solidTiles.columns)
+				return;
+
+			solidTiles.Set(_row, _col, _collision == TILE_COLLISION_SOLID);
+			oneWayTiles.Set(_row, _col, _collision == TILE_COLLISION_ONE_WAY);
+		}
+
+		// Calls _onCell(row, col, collision) for each colliding tile whose cell overlaps the world rectangle.
+		// Only the cells under the rectangle are visited, whatever the scene's size.
+		template <typename F>
+		void ForEachCollisionTile(float _minX, float _minY, float _maxX, float _maxY, const F& _onCell) const
+		{
+			if (solidTiles.rows == 0 || solidTiles.columns == 0)
+				return;
+
+			// Tiles are centered on their cell's coordinates
+			int minCol = (int)std::floor(_minX - originX + .5f);
+			int minRow = (int)std::floor(_minY - originY + .5f);
+			int maxCol = (int)std::floor(_maxX - originX + .5f);
+			int maxRow = (int)std::floor(_maxY - originY + .5f);
+
+			if (maxCol < 0 || maxRow < 0 || minCol >= (int)solidTiles.columns || minRow >= (int)solidTiles.rows)
+				return;
+
+			minCol = max(minCol, 0);
+			minRow = max(minRow, 0);
+			maxCol = min(maxCol, (int)solidTiles.columns - 1);
+			maxRow = min(maxRow, (int)solidTiles.rows - 1);
+
+			solidTiles.ForEachSet(minRow, minCol, maxRow, maxCol,
+				[&_onCell](UINT32 _row, UINT32 _col) { _onCell(_row, _col, TILE_COLLISION_SOLID); });
+			oneWayTiles.ForEachSet(minRow, minCol, maxRow, maxCol,
+				[&_onCell](UINT32 _row, UINT32 _col) { _onCell(_row, _col, TILE_COLLISION_ONE_WAY); });
+		}
+
 		bool IsPointInside(GW::MATH::GVECTORF _worldPos)
 		{
 			_worldPos.x -= originX;
@@ -188,6 +549,17 @@ namespace MAD
 				IsInRange(_worldPos.x, -_range, columns + _range) &&
 				IsInRange(_worldPos.y, -_range, rows + _range);
 		}
+
+	private:
+		// Copies the chunk's uniform tile into CHUNK_AREA new dense tiles, pointers from GetTile may not survive it
+		void MakeChunkDense(TileChunk& _chunk)
+		{
+			if (_chunk.IsDense())
+				return;
+
+			_chunk.denseOffset = (UINT32)denseTiles.size();
+			denseTiles.insert(denseTiles.end(), CHUNK_AREA, _chunk.uniformTile);
+		}
 	};
 };
 
@@ -10,21 +10,40 @@ namespace MAD
 		USHORT sceneCol;
 	};
 
+	// Relationship from a scene's entities to the entity standing for the scene, (InScene, scene)
+	struct InScene {};
+	// On a scene entity while the scene is hidden, collision and rendering skip everything InScene of it
+	struct HiddenScene {};
+	// On a scene entity once every one of the scene's tiles is spawned, it leaves with the entity when the scene is unloaded
+	struct SpawnedScene
+	{
+		USHORT sceneIndex;
+	};
+
 	struct Strawberry
 	{
 		GW::MATH::GVECTORF originalPosition;
 	};
 
+	// Static collider covering a rectangle of solid tiles, spawned when tile colliders are merged
+	struct CompoundCollider {};
+	// Tile whose collision is handled by a CompoundCollider
+	struct InCompoundCollider {};
+
 	struct Collected {};
 
 	struct FollowPlayer {};
 
-	struct TimeCollected { long long value; };
-
 	struct Touched{};
 	struct Crumbled{};
-	struct TimeTouched { long long value; };
-	struct TimeCrumbled { long long value; };
+	enum TileTimer : UCHAR
+	{
+		CRUMBLE_TIMER,	// A touched platform crumbling
+		RESPAWN_TIMER,	// A crumbled platform or collected crystal coming back
+		TILE_TIMER_COUNT
+	};
+	// TimerWheel handles of a tile's pending timers, cancelled when the tile is pooled so none fire on its next cell
+	struct TileTimers { UINT64 handles[TILE_TIMER_COUNT]; };
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,272 @@
+// Models imported once by assimp and written out the way Model keeps them, so loading one is copies out of a mapped file
+#ifndef COOKEDMODEL_H
+#define COOKEDMODEL_H
+
+#include <vector>
+#include <string>
+#include <cstring>
+
+#include "Model.h"
+#include "SceneArchive.h"
+
+namespace MAD
+{
+	struct CookedModelHeader
+	{
+		char magic[4];
+		UINT32 version;
+		// Of the FBX file it was cooked from, the cooked model is stale once the FBX no longer matches
+		UINT32 sourceChecksum;
+		// The ASSIMP_FLAGS it was imported with
+		UINT32 importFlags;
+		UINT32 vertexCount;
+		UINT32 indexCount;
+		UINT32 meshCount;
+		UINT32 materialCount;
+		// Of everything after the header
+		UINT32 checksum;
+		// Keeps the vertex stream that follows 16 byte aligned
+		UINT32 padding[3];
+	};
+
+	// Layout: header, the vertex, index, mesh and material attribute streams, the global inverse, then the bones,
+	// the nodes under the skeleton and the animation clips, each a count followed by its entries.
+	// Strings are a UINT32 length then their characters.
+	class CookedModel
+	{
+	public:
+		static constexpr char MAGIC[4] = { 'M', 'A', 'D', 'M' };
+		static constexpr UINT32 VERSION = 1;
+
+		static UINT32 GetSourceChecksum(const UCHAR* _fbxData, size_t _fbxSize)
+		{
+			return SceneArchive::Checksum(_fbxData, _fbxSize);
+		}
+
+		static void Write(const Model& _model, UINT32 _sourceChecksum, std::vector<UCHAR>& _outData)
+		{
+			_outData.assign(sizeof(CookedModelHeader), 0);
+
+			PushArray(_outData, _model.vertices);
+			PushArray(_outData, _model.indices);
+			PushArray(_outData, _model.meshes);
+			// The material names and texture paths never import, assimp only hands out buffer properties through Get
+			for (const Material& material : _model.materials)
+				Push(_outData, material.attrib);
+
+			Push(_outData, _model.globalInverse);
+
+			Push(_outData, (UINT32)_model.boneProps.size());
+			for (const BoneProperties& bone : _model.boneProps)
+			{
+				PushString(_outData, bone.boneName);
+				PushString(_outData, bone.parentName);
+				Push(_outData, bone.parentNdx);
+				Push(_outData, bone.offsetMatrix);
+			}
+
+			Push(_outData, (UINT32)_model.nodes.size());
+			for (const ModelNode& node : _model.nodes)
+			{
+				PushString(_outData, node.name);
+				Push(_outData, node.transformation);
+				Push(_outData, node.parentNdx);
+				Push(_outData, node.boneNdx);
+			}
+
+			Push(_outData, (UINT32)_model.animations.size());
+			for (const AnimationClip& clip : _model.animations)
+			{
+				PushString(_outData, clip.name);
+				Push(_outData, clip.duration);
+				Push(_outData, clip.ticksPerSecond);
+				Push(_outData, (UINT32)clip.channels.size());
+
+				for (const AnimationChannel& channel : clip.channels)
+				{
+					PushString(_outData, channel.nodeName);
+					Push(_outData, (UINT32)channel.scalingKeys.size());
+					Push(_outData, (UINT32)channel.rotationKeys.size());
+					Push(_outData, (UINT32)channel.positionKeys.size());
+					PushArray(_outData, channel.scalingKeys);
+					PushArray(_outData, channel.rotationKeys);
+					PushArray(_outData, channel.positionKeys);
+				}
+			}
+
+			CookedModelHeader header = {};
+			std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+			header.version = VERSION;
+			header.sourceChecksum = _sourceChecksum;
+			header.importFlags = ASSIMP_FLAGS;
+			header.vertexCount = (UINT32)_model.vertices.size();
+			header.indexCount = (UINT32)_model.indices.size();
+			header.meshCount = (UINT32)_model.meshes.size();
+			header.materialCount = (UINT32)_model.materials.size();
+			header.checksum = SceneArchive::Checksum(_outData.data() + sizeof(CookedModelHeader), _outData.size() - sizeof(CookedModelHeader));
+			std::memcpy(_outData.data(), &header, sizeof(CookedModelHeader));
+		}
+
+		// Fails if the data is damaged or wasn't cooked from the FBX with _sourceChecksum by this version and import flags.
+		// _outModel's modelName is left to the caller.
+		static bool Read(const UCHAR* _data, size_t _dataSize, UINT32 _sourceChecksum, Model& _outModel)
+		{
+			if (_dataSize < sizeof(CookedModelHeader))
+				return false;
+
+			CookedModelHeader header;
+			std::memcpy(&header, _data, sizeof(CookedModelHeader));
+			if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+				header.version != VERSION ||
+				header.sourceChecksum != _sourceChecksum ||
+				header.importFlags != (UINT32)ASSIMP_FLAGS ||
+				SceneArchive::Checksum(_data + sizeof(CookedModelHeader), _dataSize - sizeof(CookedModelHeader)) != header.checksum)
+				return false;
+
+			const UCHAR* cursor = _data + sizeof(CookedModelHeader);
+			const UCHAR* end = _data + _dataSize;
+
+			if (!ReadArray(cursor, end, header.vertexCount, _outModel.vertices) ||
+				!ReadArray(cursor, end, header.indexCount, _outModel.indices) ||
+				!ReadArray(cursor, end, header.meshCount, _outModel.meshes))
+				return false;
+
+			_outModel.materials.assign(header.materialCount, Material());
+			for (Material& material : _outModel.materials)
+			{
+				if (!Read(cursor, end, material.attrib))
+					return false;
+			}
+
+			UINT32 boneCount;
+			if (!Read(cursor, end, _outModel.globalInverse) || !ReadCount(cursor, end, boneCount))
+				return false;
+
+			_outModel.boneProps.resize(boneCount);
+			_outModel.boneMap.clear();
+			for (UINT32 i = 0; i < boneCount; i++)
+			{
+				BoneProperties& bone = _outModel.boneProps[i];
+				if (!ReadString(cursor, end, bone.boneName) || !ReadString(cursor, end, bone.parentName) ||
+					!Read(cursor, end, bone.parentNdx) || !Read(cursor, end, bone.offsetMatrix) ||
+					(bone.parentNdx != (unsigned)-1 && bone.parentNdx >= boneCount))
+					return false;
+
+				_outModel.boneMap[bone.boneName] = i;
+			}
+
+			UINT32 nodeCount;
+			if (!ReadCount(cursor, end, nodeCount))
+				return false;
+
+			_outModel.nodes.resize(nodeCount);
+			for (ModelNode& node : _outModel.nodes)
+			{
+				if (!ReadString(cursor, end, node.name) || !Read(cursor, end, node.transformation) ||
+					!Read(cursor, end, node.parentNdx) || !Read(cursor, end, node.boneNdx))
+					return false;
+			}
+
+			// Posing indexes by these without checking, the parent has to come before its child
+			for (int i = 0; i < (int)nodeCount; i++)
+			{
+				const ModelNode& node = _outModel.nodes[i];
+				if (node.parentNdx < -1 || node.parentNdx >= i || node.boneNdx < -1 || node.boneNdx >= (int)boneCount)
+					return false;
+			}
+
+			UINT32 clipCount;
+			if (!ReadCount(cursor, end, clipCount))
+				return false;
+
+			_outModel.animations.resize(clipCount);
+			for (AnimationClip& clip : _outModel.animations)
+			{
+				UINT32 channelCount;
+				if (!ReadString(cursor, end, clip.name) || !Read(cursor, end, clip.duration) ||
+					!Read(cursor, end, clip.ticksPerSecond) || !ReadCount(cursor, end, channelCount))
+					return false;
+
+				clip.channels.resize(channelCount);
+				for (AnimationChannel& channel : clip.channels)
+				{
+					UINT32 scalingKeyCount, rotationKeyCount, positionKeyCount;
+					if (!ReadString(cursor, end, channel.nodeName) ||
+						!Read(cursor, end, scalingKeyCount) || !Read(cursor, end, rotationKeyCount) || !Read(cursor, end, positionKeyCount) ||
+						!ReadArray(cursor, end, scalingKeyCount, channel.scalingKeys) ||
+						!ReadArray(cursor, end, rotationKeyCount, channel.rotationKeys) ||
+						!ReadArray(cursor, end, positionKeyCount, channel.positionKeys))
+						return false;
+				}
+			}
+
+			_outModel.nodeGlobals.resize(nodeCount);
+			_outModel.IndexAnimationChannels();
+			return true;
+		}
+
+	private:
+		template <typename T>
+		static void Push(std::vector<UCHAR>& _outData, const T& _value)
+		{
+			_outData.insert(_outData.end(), (const UCHAR*)&_value, (const UCHAR*)&_value + sizeof(T));
+		}
+
+		template <typename T>
+		static void PushArray(std::vector<UCHAR>& _outData, const std::vector<T>& _values)
+		{
+			if (!_values.empty())
+				_outData.insert(_outData.end(), (const UCHAR*)_values.data(), (const UCHAR*)(_values.data() + _values.size()));
+		}
+
+		static void PushString(std::vector<UCHAR>& _outData, const std::string& _value)
+		{
+			Push(_outData, (UINT32)_value.size());
+			_outData.insert(_outData.end(), _value.begin(), _value.end());
+		}
+
+		// Entries past the header aren't aligned, so everything is copied out
+		template <typename T>
+		static bool Read(const UCHAR*& _cursor, const UCHAR* _end, T& _outValue)
+		{
+			if ((size_t)(_end - _cursor) < sizeof(T))
+				return false;
+
+			std::memcpy(&_outValue, _cursor, sizeof(T));
+			_cursor += sizeof(T);
+			return true;
+		}
+
+		template <typename T>
+		static bool ReadArray(const UCHAR*& _cursor, const UCHAR* _end, UINT32 _count, std::vector<T>& _outValues)
+		{
+			if ((size_t)(_end - _cursor) / sizeof(T) < _count)
+				return false;
+
+			_outValues.resize(_count);
+			if (_count > 0)
+				std::memcpy(_outValues.data(), _cursor, (size_t)_count * sizeof(T));
+			_cursor += (size_t)_count * sizeof(T);
+			return true;
+		}
+
+		// Every entry a count is followed by takes at least four bytes, so counts past that can't be real
+		static bool ReadCount(const UCHAR*& _cursor, const UCHAR* _end, UINT32& _outCount)
+		{
+			return Read(_cursor, _end, _outCount) && _outCount <= (size_t)(_end - _cursor) / sizeof(UINT32);
+		}
+
+		static bool ReadString(const UCHAR*& _cursor, const UCHAR* _end, std::string& _outValue)
+		{
+			UINT32 length;
+			if (!Read(_cursor, _end, length) || (size_t)(_end - _cursor) < length)
+				return false;
+
+			_outValue.assign((const char*)_cursor, length);
+			_cursor += length;
+			return true;
+		}
+	};
+};
+
+#endif
@@ -6,8 +6,6 @@ using namespace MAD;
 
 MAD::Model::Model()
 {
-	parser = new Assimp::Importer();
-
 	globalInverse = GW::MATH::GIdentityMatrixF;
 	world = GW::MATH::GIdentityMatrixF;
 
@@ -20,71 +18,27 @@ MAD::Model::Model()
 	vertices.clear();
 	indices.clear();
 
-	model = nullptr;
-	skeleton = nullptr;
 	vertexStart = 0;
 	indexStart = 0;
 	materialStart = 0;
 }
 
-MAD::Model::~Model()
-{
-
-}
-
-MAD::Model::Model(const Model& other)
-	: parser(new Assimp::Importer()), skeleton(other.skeleton),
-	positions(other.positions), uvs(other.uvs), norms(other.norms),
-	bones(other.bones), boneMap(other.boneMap), boneProps(other.boneProps),
-	globalInverse(other.globalInverse), model(other.model),
-	modelName(other.modelName), meshes(other.meshes), vertices(other.vertices),
-	indices(other.indices), vertexStart(other.vertexStart), indexStart(other.indexStart), 
-	materials(other.materials), materialStart(other.materialStart), 
-	currPose(other.currPose), skeletonVerts(other.skeletonVerts), world(other.world){}
-
-Model& MAD::Model::operator=(const Model& other)
-{
-	if (this == &other) {
-		return *this;
-	}
-
-	delete parser;
-
-	parser = new Assimp::Importer();
-	skeleton = other.skeleton;
-	positions = other.positions;
-	uvs = other.uvs;
-	norms = other.norms;
-	bones = other.bones;
-	boneMap = other.boneMap;
-	boneProps = other.boneProps;
-	globalInverse = other.globalInverse;
-	model = other.model;
-	modelName = other.modelName;
-	meshes = other.meshes;
-	vertices = other.vertices;
-	indices = other.indices;
-	vertexStart = other.vertexStart;
-	indexStart = other.indexStart;
-	materials = other.materials;
-	materialStart = other.materialStart;
-	currPose = other.currPose;
-	skeletonVerts = other.skeletonVerts;
-	world = other.world;
-
-	return *this;
-}
-
 bool MAD::Model::LoadModel(const std::string& filePath, const std::string& fbxName)
 {
 	std::string fullPath = filePath + fbxName;
-	model = parser->ReadFile(fullPath, ASSIMP_FLAGS);
+	Assimp::Importer importer;
+	const aiScene* model = importer.ReadFile(fullPath, ASSIMP_FLAGS);
 
 	if (model)
 	{
 		modelName = fbxName;
-		skeleton = FindSkeletonNode(model);
 		ParseModel(model);
+
+		const aiNode* skeleton = FindSkeletonNode(model);
+		ParseNodes((skeleton) ? skeleton : model->mRootNode);
+		ParseAnimations(model);
+		IndexAnimationChannels();
+
 		globalInverse = (GW::MATH::GMATRIXF&)(model->mRootNode->mTransformation);
 		GW::MATH::GMatrix::InverseF(globalInverse, globalInverse);
 		return true;
@@ -93,6 +47,11 @@ bool MAD::Model::LoadModel(const std::string& filePath, const std::string& fbxNa
 	return false;
 }
 
+bool MAD::Model::HasAnimations() const
+{
+	return !animations.empty();
+}
+
 void MAD::Model::UpdatePose(float duration, unsigned animationNdx)
 {
 	GW::GReturn ret = {};
@@ -291,6 +250,82 @@ void MAD::Model::ParseModel(const aiScene* model)
 
 }
 
+// Flattens the hierarchy under start depth first, children in the order the recursive walk used to visit them
+void MAD::Model::ParseNodes(const aiNode* start)
+{
+	nodes.clear();
+
+	std::vector<std::pair<const aiNode*, int>> stack = { { start, -1 } };
+	while (!stack.empty())
+	{
+		const aiNode* node = stack.back().first;
+		int parentNdx = stack.back().second;
+		stack.pop_back();
+
+		ModelNode modelNode;
+		modelNode.name = node->mName.C_Str();
+		modelNode.transformation = (GW::MATH::GMATRIXF&)(node->mTransformation);
+		modelNode.parentNdx = parentNdx;
+		modelNode.boneNdx = GetBoneIndex(modelNode.name);
+		nodes.push_back(modelNode);
+
+		for (int i = (int)node->mNumChildren - 1; i >= 0; i--)
+		{
+			stack.push_back({ node->mChildren[i], (int)nodes.size() - 1 });
+		}
+	}
+
+	nodeGlobals.resize(nodes.size());
+}
+
+void MAD::Model::ParseAnimations(const aiScene* model)
+{
+	animations.resize(model->mNumAnimations);
+
+	for (int i = 0; i < model->mNumAnimations; i++)
+	{
+		const aiAnimation* animation = model->mAnimations[i];
+		AnimationClip& clip = animations[i];
+
+		clip.name = animation->mName.C_Str();
+		clip.duration = animation->mDuration;
+		clip.ticksPerSecond = animation->mTicksPerSecond;
+		clip.channels.resize(animation->mNumChannels);
+
+		for (int j = 0; j < animation->mNumChannels; j++)
+		{
+			const aiNodeAnim* nodeAnim = animation->mChannels[j];
+			AnimationChannel& channel = clip.channels[j];
+
+			channel.nodeName = nodeAnim->mNodeName.C_Str();
+			channel.scalingKeys.assign(nodeAnim->mScalingKeys, nodeAnim->mScalingKeys + nodeAnim->mNumScalingKeys);
+			channel.rotationKeys.assign(nodeAnim->mRotationKeys, nodeAnim->mRotationKeys + nodeAnim->mNumRotationKeys);
+			channel.positionKeys.assign(nodeAnim->mPositionKeys, nodeAnim->mPositionKeys + nodeAnim->mNumPositionKeys);
+		}
+	}
+}
+
+// Looks up each node's channel once instead of by name every frame, the first channel naming a node animates it
+void MAD::Model::IndexAnimationChannels()
+{
+	for (AnimationClip& clip : animations)
+	{
+		clip.nodeChannels.assign(nodes.size(), -1);
+
+		for (size_t i = 0; i < nodes.size(); i++)
+		{
+			for (size_t j = 0; j < clip.channels.size(); j++)
+			{
+				if (clip.channels[j].nodeName == nodes[i].name)
+				{
+					clip.nodeChannels[i] = (int)j;
+					break;
+				}
+			}
+		}
+	}
+}
+
 int MAD::Model::GetBoneIndex(const aiBone* bone)
 {
 	int boneNdx = 0;
@@ -349,19 +384,17 @@ const aiNode* MAD::Model::FindSkeletonNode(const aiScene* model)
 
 std::vector<GW::MATH::GMATRIXF> MAD::Model::BoneTransform(float seconds, UINT animationNdx)
 {
-	if (!model->HasAnimations())
+	if (!HasAnimations())
 		return std::vector<GW::MATH::GMATRIXF>();
 
 
-	if (animationNdx >= model->mNumAnimations) 
+	if (animationNdx >= animations.size()) 
 		return std::vector<GW::MATH::GMATRIXF>();
 
-	const aiAnimation* animation = model->mAnimations[animationNdx];
+	const AnimationClip& animation = animations[animationNdx];
 	float animationTime = CalcAnimationTime(seconds, animation);
 
-	GW::MATH::GMATRIXF identity = GW::MATH::GIdentityMatrixF;
-	const aiNode* start = (skeleton) ? skeleton : model->mRootNode;
-	ReadNodeHierarchy(animationTime, start, animation, identity);
+	ReadNodeHierarchy(animationTime, animation);
 
 	std::vector<GW::MATH::GMATRIXF> transforms;
 	transforms.resize(boneProps.size());
@@ -376,22 +409,19 @@ std::vector<GW::MATH::GMATRIXF> MAD::Model::BoneTransform(float seconds, UINT an
 
 std::vector<GW::MATH::GMATRIXF> MAD::Model::BoneTransformBlended(float seconds, UINT startAnimationNdx, UINT endAnimationNdx, float transitionTime)
 {
-	if (!model->HasAnimations())
+	if (!HasAnimations())
 		return std::vector<GW::MATH::GMATRIXF>();
 
-	if (startAnimationNdx >= model->mNumAnimations || endAnimationNdx >= model->mNumAnimations)
+	if (startAnimationNdx >= animations.size() || endAnimationNdx >= animations.size())
 		return std::vector<GW::MATH::GMATRIXF>();
 
-	const aiAnimation* startAnimation = model->mAnimations[startAnimationNdx];
+	const AnimationClip& startAnimation = animations[startAnimationNdx];
 	float startAnimationTime = CalcAnimationTime(seconds, startAnimation);
 
-	const aiAnimation* endAnimation = model->mAnimations[endAnimationNdx];
+	const AnimationClip& endAnimation = animations[endAnimationNdx];
 	float endAnimationTime = CalcAnimationTime(seconds, endAnimation);
 
-	GW::MATH::GMATRIXF identity = GW::MATH::GIdentityMatrixF;
-
-	const aiNode* start = (skeleton) ? skeleton : model->mRootNode;
-	ReadNodeHierarchyBlended(transitionTime, startAnimationTime, endAnimationTime, start, startAnimation, endAnimation, identity);
+	ReadNodeHierarchyBlended(transitionTime, startAnimationTime, endAnimationTime, startAnimation, endAnimation);
 
 	std::vector<GW::MATH::GMATRIXF> transforms;
 	transforms.resize(boneProps.size());
@@ -404,240 +434,202 @@ std::vector<GW::MATH::GMATRIXF> MAD::Model::BoneTransformBlended(float seconds,
 	return transforms;
 }
 
-void MAD::Model::ReadNodeHierarchy(float duration, const aiNode* node, const aiAnimation* animation, const GW::MATH::GMATRIXF& parentTransform)
+// Parents come before their children in nodes, so one pass in order sees every parent's global matrix first
+void MAD::Model::ReadNodeHierarchy(float duration, const AnimationClip& animation)
 {
-	if (!node || !animation)
+	for (unsigned i = 0; i < nodes.size(); i++)
 	{
-		return;
-	}
-
-	std::string nodeName = node->mName.C_Str();
-
-	GW::MATH::GMATRIXF nodeTransformation = (GW::MATH::GMATRIXF&)(node->mTransformation);
-
-	const aiNodeAnim* nodeAnim = FindAnimationNode(animation, nodeName);
-
-	LocalTransform localTransform = {};
+		int channelNdx = animation.nodeChannels[i];
 
-	if (nodeAnim)
-		CalcLocalTransform(localTransform, duration, nodeAnim);
+		LocalTransform localTransform = {};
 
-	nodeTransformation = (GW::MATH::GMATRIXF&)(aiMatrix4x4(localTransform.scale, localTransform.rotation, localTransform.translation));
+		if (channelNdx != -1)
+			CalcLocalTransform(localTransform, duration, animation.channels[channelNdx]);
 
-	GW::MATH::GMATRIXF global_matrix = GW::MATH::GIdentityMatrixF;
-	GW::MATH::GMatrix::MultiplyMatrixF(parentTransform, nodeTransformation, global_matrix);
-
-	if (boneMap.find(nodeName) != boneMap.end())
-	{		
-		UINT bone_index = boneMap[nodeName];
-		GW::MATH::GMATRIXF result_matrix = GW::MATH::GIdentityMatrixF;
-		GW::MATH::GMatrix::MultiplyMatrixF(globalInverse, global_matrix, result_matrix);
-		GW::MATH::GMatrix::MultiplyMatrixF(result_matrix, boneProps[bone_index].offsetMatrix, boneProps[bone_index].finalTransform);
-
-		boneProps[bone_index].skeletonMatrix = global_matrix;
-	}
-
-	for (size_t i = 0; i < node->mNumChildren; i++)
-	{
-		ReadNodeHierarchy(duration, node->mChildren[i], animation, global_matrix);
+		GW::MATH::GMATRIXF nodeTransformation = (GW::MATH::GMATRIXF&)(aiMatrix4x4(localTransform.scale, localTransform.rotation, localTransform.translation));
+		SetNodeGlobal(i, nodeTransformation);
 	}
 }
 
-void MAD::Model::ReadNodeHierarchyBlended(float transitionTime, float startAnimDuration, float endAnimDuration, const aiNode* node, const aiAnimation* startAnimation, const aiAnimation* endAnimation, const GW::MATH::GMATRIXF& parentTransform)
+void MAD::Model::ReadNodeHierarchyBlended(float transitionTime, float startAnimDuration, float endAnimDuration, const AnimationClip& startAnimation, const AnimationClip& endAnimation)
 {
-	if (!node || !startAnimation || !endAnimation)
-		return;
-
-	std::string nodeName = node->mName.C_Str();
+	for (unsigned i = 0; i < nodes.size(); i++)
+	{
+		GW::MATH::GMATRIXF nodeTransformation = nodes[i].transformation;
 
-	GW::MATH::GMATRIXF nodeTransformation = (GW::MATH::GMATRIXF&)(node->mTransformation);
+		int startChannelNdx = startAnimation.nodeChannels[i];
+		int endChannelNdx = endAnimation.nodeChannels[i];
 
-	const aiNodeAnim* startNodeAnim = FindAnimationNode(startAnimation, nodeName);
+		//transitionTime = std::clamp(transitionTime, 0.0f, 1.0f);
+		LocalTransform startTransform = {};
+		if (startChannelNdx != -1)
+			CalcLocalTransform(startTransform, startAnimDuration, startAnimation.channels[startChannelNdx]);
 
-	const aiNodeAnim* endNodeAnim = FindAnimationNode(endAnimation, nodeName);
+		LocalTransform endTransform = {};
+		if (endChannelNdx != -1)
+			CalcLocalTransform(endTransform, endAnimDuration, endAnimation.channels[endChannelNdx]);
 
-	//transitionTime = std::clamp(transitionTime, 0.0f, 1.0f);
-	LocalTransform startTransform = {};
-	if (startNodeAnim)
-		CalcLocalTransform(startTransform, startAnimDuration, startNodeAnim);
+		if (startChannelNdx != -1 && endChannelNdx != -1)
+		{
+			aiVector3D blendedScale = startTransform.scale * (1.0f - transitionTime) + endTransform.scale * transitionTime;
 
-	LocalTransform endTransform = {};
-	if (endNodeAnim)
-		CalcLocalTransform(endTransform, endAnimDuration, endNodeAnim);
+			aiQuaternion blendedRotation = {};
+			aiQuaternion::Interpolate(blendedRotation, startTransform.rotation, endTransform.rotation, transitionTime);
+			blendedRotation.Normalize();
 
-	if (startNodeAnim && endNodeAnim)
-	{
-		aiVector3D blendedScale = startTransform.scale * (1.0f - transitionTime) + endTransform.scale * transitionTime;
+			aiVector3D blendedTranslation = startTransform.translation * (1.0f - transitionTime) + endTransform.translation * transitionTime;
 
-		aiQuaternion blendedRotation = {};
-		aiQuaternion::Interpolate(blendedRotation, startTransform.rotation, endTransform.rotation, transitionTime);
-		blendedRotation.Normalize();
-		
-		aiVector3D blendedTranslation = startTransform.translation * (1.0f - transitionTime) + endTransform.translation * transitionTime;
+			nodeTransformation = (GW::MATH::GMATRIXF&)(aiMatrix4x4(blendedScale, blendedRotation, blendedTranslation));
+		}
 
-		nodeTransformation = (GW::MATH::GMATRIXF&)(aiMatrix4x4(blendedScale, blendedRotation, blendedTranslation));
+		SetNodeGlobal(i, nodeTransformation);
 	}
+}
 
-	GW::MATH::GMATRIXF global_matrix = GW::MATH::GIdentityMatrixF;
+void MAD::Model::SetNodeGlobal(unsigned nodeNdx, const GW::MATH::GMATRIXF& nodeTransformation)
+{
+	const ModelNode& node = nodes[nodeNdx];
+	const GW::MATH::GMATRIXF& parentTransform = (node.parentNdx != -1) ? nodeGlobals[node.parentNdx] : GW::MATH::GIdentityMatrixF;
+
+	GW::MATH::GMATRIXF& global_matrix = nodeGlobals[nodeNdx];
 	GW::MATH::GMatrix::MultiplyMatrixF(parentTransform, nodeTransformation, global_matrix);
 
-	if (boneMap.find(nodeName) != boneMap.end())
+	if (node.boneNdx != -1)
 	{
-		UINT bone_index = boneMap[nodeName];
+		BoneProperties& bone = boneProps[node.boneNdx];
 		GW::MATH::GMATRIXF result_matrix = GW::MATH::GIdentityMatrixF;
 		GW::MATH::GMatrix::MultiplyMatrixF(globalInverse, global_matrix, result_matrix);
-		GW::MATH::GMatrix::MultiplyMatrixF(result_matrix, boneProps[bone_index].offsetMatrix, boneProps[bone_index].finalTransform);
-
-		boneProps[bone_index].skeletonMatrix = global_matrix;
-	}
-
-	for (size_t i = 0; i < node->mNumChildren; i++)
-	{
-		ReadNodeHierarchyBlended(transitionTime, startAnimDuration, endAnimDuration, node->mChildren[i], startAnimation, endAnimation, global_matrix);
-	}
-}
+		GW::MATH::GMatrix::MultiplyMatrixF(result_matrix, bone.offsetMatrix, bone.finalTransform);
 
-const aiNodeAnim* MAD::Model::FindAnimationNode(const aiAnimation* animation, const std::string nodeName)
-{
-	if (animation)
-	{
-		for (size_t i = 0; i < animation->mNumChannels; i++)
-		{
-			const aiNodeAnim* nodeAnim = animation->mChannels[i];
-			if (strcmp(nodeName.c_str(), nodeAnim->mNodeName.C_Str()) == 0)
-			{
-				return nodeAnim;
-			}
-		}
+		bone.skeletonMatrix = global_matrix;
 	}
-	return nullptr;
 }
 
-void MAD::Model::CalcInterpolatedScalingVector(aiVector3D& out, float duration, const aiNodeAnim* nodeAnim)
+void MAD::Model::CalcInterpolatedScalingVector(aiVector3D& out, float duration, const AnimationChannel& nodeAnim)
 {
-	if (nodeAnim->mNumScalingKeys == 1)
+	if (nodeAnim.scalingKeys.size() == 1)
 	{
-		out = nodeAnim->mScalingKeys[0].mValue;
+		out = nodeAnim.scalingKeys[0].mValue;
 		return;
 	}
 
 	unsigned scaling_index = FindScalingAnimationIndex(duration, nodeAnim);
-	unsigned next_scaling_index = (scaling_index + 1) % nodeAnim->mNumScalingKeys;
-	if (next_scaling_index < nodeAnim->mNumScalingKeys)
+	unsigned next_scaling_index = (scaling_index + 1) % nodeAnim.scalingKeys.size();
+	if (next_scaling_index < nodeAnim.scalingKeys.size())
 	{
-		float t1 = (float)nodeAnim->mScalingKeys[scaling_index].mTime;
-		float t2 = (float)nodeAnim->mScalingKeys[next_scaling_index].mTime;
+		float t1 = (float)nodeAnim.scalingKeys[scaling_index].mTime;
+		float t2 = (float)nodeAnim.scalingKeys[next_scaling_index].mTime;
 		float delta_time = t2 - t1;
 		float factor = (duration - t1) / delta_time;
 		if (factor >= 0.0f && factor <= 1.0f)
 		{
-			const aiVector3D& start = nodeAnim->mScalingKeys[scaling_index].mValue;
-			const aiVector3D& end = nodeAnim->mScalingKeys[next_scaling_index].mValue;
+			const aiVector3D& start = nodeAnim.scalingKeys[scaling_index].mValue;
+			const aiVector3D& end = nodeAnim.scalingKeys[next_scaling_index].mValue;
 			aiVector3D delta = end - start;
 			out = start + factor * delta;
 		}
 	}
 }
 
-void MAD::Model::CalcInterpolatedRotationQuaternion(aiQuaternion& out, float duration, const aiNodeAnim* nodeAnim)
+void MAD::Model::CalcInterpolatedRotationQuaternion(aiQuaternion& out, float duration, const AnimationChannel& nodeAnim)
 {
-	if (nodeAnim->mNumRotationKeys == 1)
+	if (nodeAnim.rotationKeys.size() == 1)
 	{
-		out = nodeAnim->mRotationKeys[0].mValue;
+		out = nodeAnim.rotationKeys[0].mValue;
 		return;
 	}
 
 	unsigned rotation_index = FindRotationAnimationIndex(duration, nodeAnim);
-	unsigned next_rotation_index = (rotation_index + 1) % nodeAnim->mNumRotationKeys;
-	if (next_rotation_index < nodeAnim->mNumRotationKeys)
+	unsigned next_rotation_index = (rotation_index + 1) % nodeAnim.rotationKeys.size();
+	if (next_rotation_index < nodeAnim.rotationKeys.size())
 	{
-		float t1 = (float)nodeAnim->mRotationKeys[rotation_index].mTime;
-		float t2 = (float)nodeAnim->mRotationKeys[next_rotation_index].mTime;
+		float t1 = (float)nodeAnim.rotationKeys[rotation_index].mTime;
+		float t2 = (float)nodeAnim.rotationKeys[next_rotation_index].mTime;
 		float delta_time = t2 - t1;
 		float factor = (duration - t1) / delta_time;
 		if (factor >= 0.0f && factor <= 1.0f)
 		{
-			const aiQuaternion& start = nodeAnim->mRotationKeys[rotation_index].mValue;
-			const aiQuaternion& end = nodeAnim->mRotationKeys[next_rotation_index].mValue;
+			const aiQuaternion& start = nodeAnim.rotationKeys[rotation_index].mValue;
+			const aiQuaternion& end = nodeAnim.rotationKeys[next_rotation_index].mValue;
 			aiQuaternion::Interpolate(out, start, end, factor);
 			out.Normalize();
 		}
 	}
 }
 
-void MAD::Model::CalcInterpolatedTranslationVector(aiVector3D& out, float duration, const aiNodeAnim* nodeAnim)
+void MAD::Model::CalcInterpolatedTranslationVector(aiVector3D& out, float duration, const AnimationChannel& nodeAnim)
 {
-	if (nodeAnim->mNumPositionKeys == 1)
+	if (nodeAnim.positionKeys.size() == 1)
 	{
-		out = nodeAnim->mPositionKeys[0].mValue;
+		out = nodeAnim.positionKeys[0].mValue;
 		return;
 	}
 
 	unsigned translation_index = FindTranslationAnimationIndex(duration, nodeAnim);
-	unsigned next_translation_index = (translation_index + 1) % nodeAnim->mNumPositionKeys;
-	if (next_translation_index < nodeAnim->mNumPositionKeys)
+	unsigned next_translation_index = (translation_index + 1) % nodeAnim.positionKeys.size();
+	if (next_translation_index < nodeAnim.positionKeys.size())
 	{
-		float t1 = (float)nodeAnim->mPositionKeys[translation_index].mTime;
-		float t2 = (float)nodeAnim->mPositionKeys[next_translation_index].mTime;
+		float t1 = (float)nodeAnim.positionKeys[translation_index].mTime;
+		float t2 = (float)nodeAnim.positionKeys[next_translation_index].mTime;
 		float delta_time = t2 - t1;
 		float factor = (duration - t1) / delta_time;
 		if (factor >= 0.0f && factor <= 1.0f)
 		{
-			const aiVector3D& start = nodeAnim->mPositionKeys[translation_index].mValue;
-			const aiVector3D& end = nodeAnim->mPositionKeys[next_translation_index].mValue;
+			const aiVector3D& start = nodeAnim.positionKeys[translation_index].mValue;
+			const aiVector3D& end = nodeAnim.positionKeys[next_translation_index].mValue;
 			aiVector3D delta = end - start;
 			out = start + factor * delta;
 		}
 	}
 }
 
-void MAD::Model::CalcLocalTransform(LocalTransform& out, float duration, const aiNodeAnim* nodeAnim)
+void MAD::Model::CalcLocalTransform(LocalTransform& out, float duration, const AnimationChannel& nodeAnim)
 {
 	CalcInterpolatedScalingVector(out.scale, duration, nodeAnim);
 	CalcInterpolatedRotationQuaternion(out.rotation, duration, nodeAnim);
 	CalcInterpolatedTranslationVector(out.translation, duration, nodeAnim);
 }
 
-float MAD::Model::CalcAnimationTime(float seconds, const aiAnimation* animation)
+float MAD::Model::CalcAnimationTime(float seconds, const AnimationClip& animation)
 {
-	float ticksPerSecond = (animation->mTicksPerSecond != 0) ? animation->mTicksPerSecond : 30.0f;
+	float ticksPerSecond = (animation.ticksPerSecond != 0) ? animation.ticksPerSecond : 30.0f;
 	float timeInTicks = seconds * ticksPerSecond;
-	return (float)fmod(timeInTicks, animation->mDuration);
+	return (float)fmod(timeInTicks, animation.duration);
 }
 
-unsigned MAD::Model::FindScalingAnimationIndex(float duration, const aiNodeAnim* nodeAnim)
+unsigned MAD::Model::FindScalingAnimationIndex(float duration, const AnimationChannel& nodeAnim)
 {
-	if (nodeAnim->mNumScalingKeys > 0)
+	if (nodeAnim.scalingKeys.size() > 0)
 	{
-		for (unsigned i = 0; i < nodeAnim->mNumScalingKeys - 1; i++)
+		for (unsigned i = 0; i < (unsigned)nodeAnim.scalingKeys.size() - 1; i++)
 		{
-			float t = nodeAnim->mScalingKeys[i + 1].mTime;
+			float t = nodeAnim.scalingKeys[i + 1].mTime;
 			if (duration < t) return i;
 		}
 	}
 	return 0;
 }
 
-unsigned MAD::Model::FindRotationAnimationIndex(float duration, const aiNodeAnim* nodeAnim)
+unsigned MAD::Model::FindRotationAnimationIndex(float duration, const AnimationChannel& nodeAnim)
 {
-	if (nodeAnim->mNumRotationKeys > 0)
+	if (nodeAnim.rotationKeys.size() > 0)
 	{
-		for (unsigned i = 0; i < nodeAnim->mNumRotationKeys - 1; i++)
+		for (unsigned i = 0; i < (unsigned)nodeAnim.rotationKeys.size() - 1; i++)
 		{
-			float t = nodeAnim->mRotationKeys[i + 1].mTime;
+			float t = nodeAnim.rotationKeys[i + 1].mTime;
 			if (duration < t) return i;
 		}
 	}
 	return 0;
 }
 
-unsigned MAD::Model::FindTranslationAnimationIndex(float duration, const aiNodeAnim* nodeAnim)
+unsigned MAD::Model::FindTranslationAnimationIndex(float duration, const AnimationChannel& nodeAnim)
 {
-	if (nodeAnim->mNumPositionKeys > 0)
+	if (nodeAnim.positionKeys.size() > 0)
 	{
-		for (unsigned i = 0; i < nodeAnim->mNumPositionKeys - 1; i++)
+		for (unsigned i = 0; i < (unsigned)nodeAnim.positionKeys.size() - 1; i++)
 		{
-			float t = (float)nodeAnim->mPositionKeys[i + 1].mTime;
+			float t = (float)nodeAnim.positionKeys[i + 1].mTime;
 			if (duration < t) return i;
 		}
 	}
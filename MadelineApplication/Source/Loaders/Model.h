@@ -109,11 +109,41 @@ namespace MAD
 		GW::MATH::GMATRIXF skeletonMatrix;
 	};
 
+	// A node under the skeleton, nodes are stored so that each one's parent comes before it
+	struct ModelNode
+	{
+		std::string name;
+		GW::MATH::GMATRIXF transformation;
+		int parentNdx;
+		// -1 if no bone is named after the node
+		int boneNdx;
+	};
+
+	struct AnimationChannel
+	{
+		std::string nodeName;
+		std::vector<aiVectorKey> scalingKeys;
+		std::vector<aiQuatKey> rotationKeys;
+		std::vector<aiVectorKey> positionKeys;
+	};
+
+	// What's kept of an aiAnimation once the importer is gone
+	struct AnimationClip
+	{
+		std::string name;
+		double duration;
+		double ticksPerSecond;
+		std::vector<AnimationChannel> channels;
+		// The channel animating each node or -1, filled by IndexAnimationChannels
+		std::vector<int> nodeChannels;
+	};
+
 	class Model
 	{
+		// Writes and reads everything below that LoadModel fills in
+		friend class CookedModel;
+
 	private:
-		Assimp::Importer* parser;	
-		const aiNode* skeleton;
 
 		std::vector<GW::MATH2D::GVECTOR3F> positions;
 		std::vector<GW::MATH2D::GVECTOR2F> uvs;
@@ -125,26 +155,33 @@ namespace MAD
 
 		GW::MATH::GMATRIXF globalInverse;
 
+		std::vector<ModelNode> nodes;
+		std::vector<AnimationClip> animations;
+		// Scratch for the pose being built, one per node
+		std::vector<GW::MATH::GMATRIXF> nodeGlobals;
+
 		void ParseModel(const aiScene* model);
+		void ParseNodes(const aiNode* start);
+		void ParseAnimations(const aiScene* model);
+		void IndexAnimationChannels();
 		int GetBoneIndex(const aiBone* bone);
 		int GetBoneIndex(const std::string& bone);
 		const aiNode* FindSkeletonNode(const aiScene* scene);
 		std::vector<GW::MATH::GMATRIXF> BoneTransform(float seconds, UINT animationNdx);
 		std::vector<GW::MATH::GMATRIXF> BoneTransformBlended(float seconds, UINT startAnimationNdx, UINT endAnimationNdx, float transitionTime);
-		void ReadNodeHierarchy(float duration, const aiNode* node, const aiAnimation* animation, const GW::MATH::GMATRIXF& parentTransform);
-		void ReadNodeHierarchyBlended(float transitionTime, float startAnimDuration, float endAnimDuration, const aiNode* node, const aiAnimation* startAnimation, const aiAnimation* endAnimation, const GW::MATH::GMATRIXF& parentTransform);
-		const aiNodeAnim* FindAnimationNode(const aiAnimation* animation, const std::string nodeName);
-		void CalcInterpolatedScalingVector(aiVector3D& out, float duration, const aiNodeAnim* nodeAnim);
-		void CalcInterpolatedRotationQuaternion(aiQuaternion& out, float duration, const aiNodeAnim* nodeAnim);
-		void CalcInterpolatedTranslationVector(aiVector3D& out, float duration, const aiNodeAnim* nodeAnim);
-		void CalcLocalTransform(LocalTransform& out, float duration, const aiNodeAnim* nodeAnim);
-		float CalcAnimationTime(float seconds, const aiAnimation* animation);
-		unsigned FindScalingAnimationIndex(float duration, const aiNodeAnim* nodeAnim);
-		unsigned FindRotationAnimationIndex(float duration, const aiNodeAnim* nodeAnim);
-		unsigned FindTranslationAnimationIndex(float duration, const aiNodeAnim* nodeAnim);
+		void ReadNodeHierarchy(float duration, const AnimationClip& animation);
+		void ReadNodeHierarchyBlended(float transitionTime, float startAnimDuration, float endAnimDuration, const AnimationClip& startAnimation, const AnimationClip& endAnimation);
+		void SetNodeGlobal(unsigned nodeNdx, const GW::MATH::GMATRIXF& nodeTransformation);
+		void CalcInterpolatedScalingVector(aiVector3D& out, float duration, const AnimationChannel& nodeAnim);
+		void CalcInterpolatedRotationQuaternion(aiQuaternion& out, float duration, const AnimationChannel& nodeAnim);
+		void CalcInterpolatedTranslationVector(aiVector3D& out, float duration, const AnimationChannel& nodeAnim);
+		void CalcLocalTransform(LocalTransform& out, float duration, const AnimationChannel& nodeAnim);
+		float CalcAnimationTime(float seconds, const AnimationClip& animation);
+		unsigned FindScalingAnimationIndex(float duration, const AnimationChannel& nodeAnim);
+		unsigned FindRotationAnimationIndex(float duration, const AnimationChannel& nodeAnim);
+		unsigned FindTranslationAnimationIndex(float duration, const AnimationChannel& nodeAnim);
 
 	public:
-		const aiScene* model;
 		std::string modelName;
 
 		std::vector<Mesh> meshes;
@@ -161,10 +198,9 @@ namespace MAD
 		GW::MATH::GMATRIXF world;
 
 		Model();
-		Model(const Model& other);
-		Model& operator =(const Model& other);
-		~Model();
+		// Imports the FBX with assimp, which is only needed until this returns
 		bool LoadModel(const std::string& fileName, const std::string& fbxName);
+		bool HasAnimations() const;
 		void UpdatePose(float duration, unsigned animationNdx);
 		void UpdatePoseBlended(float duration, unsigned startAnimationNdx, unsigned endEnimationNdx, float transitionTime);
 		
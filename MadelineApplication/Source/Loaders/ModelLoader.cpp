@@ -1,4 +1,9 @@
 #include "ModelLoader.h"
+#include "CookedModel.h"
+
+#include <fstream>
+#include <atomic>
+#include <chrono>
 
 MAD::ModelLoader::ModelLoader()
 {
@@ -19,6 +24,8 @@ bool MAD::ModelLoader::InitModels(std::weak_ptr<const GameConfig> _gameConfig, G
 	//UnloadModels();// clear previous level data if there is any
 
 	std::shared_ptr<const GameConfig> readCfg = _gameConfig.lock();
+	cookedModelsPath = readCfg->at("AssetPaths").at("cookedModelsPath").as<std::string>();
+	loadThreads = readCfg->at("AssetPaths").at("modelLoadThreads").as<unsigned>();
 
 	if (ReadFBXFiles(readCfg->at("AssetPaths").at("modelsPath").as<std::string>().c_str(), _log) == false)
 	{
@@ -71,19 +78,150 @@ bool MAD::ModelLoader::ReadFBXFiles(const char* _fbxFolderPath, GW::SYSTEM::GLog
 	_log.LogCategorized("MESSAGE", "Begin Importing .FBX File Data.");
 	FindFBXNames(_fbxFolderPath, _log);
 
-	for (int i = 0; i < fbxNames.size(); i += 1)
+	std::vector<Model> loadedModels;
+	unsigned cookedCount = 0;
+	LoadModels(_fbxFolderPath, loadedModels, cookedCount, _log);
+
+	// Appended in fbxNames order whichever thread finished first, so each model's index and stream offsets stay the same
+	for (Model& model : loadedModels)
 	{
-		Model* model = new Model();
-		model->LoadModel(_fbxFolderPath, fbxNames[i]);
-		model->vertexStart = vertices.size();
-		model->indexStart = indices.size();
-		model->materialStart = materials.size();
-		models.push_back(*model);
-		vertices.insert(vertices.end(), model->vertices.begin(), model->vertices.end());
-		indices.insert(indices.end(), model->indices.begin(), model->indices.end());
-		materials.insert(materials.end(), model->materials.begin(), model->materials.end());
-		delete model;
+		model.vertexStart = vertices.size();
+		model.indexStart = indices.size();
+		model.materialStart = materials.size();
+		vertices.insert(vertices.end(), model.vertices.begin(), model.vertices.end());
+		indices.insert(indices.end(), model.indices.begin(), model.indices.end());
+		materials.insert(materials.end(), model.materials.begin(), model.materials.end());
+		models.push_back(std::move(model));
 	}
 
+	if (cookedCount > 0)
+		_log.LogCategorized("MESSAGE", (std::to_string(cookedCount) + " models were imported from their FBX and cooked again.").c_str());
+
 	return true;
 }
+
+bool MAD::ModelLoader::CookModels(std::weak_ptr<const GameConfig> _gameConfig, GW::SYSTEM::GLog _log)
+{
+	std::shared_ptr<const GameConfig> readCfg = _gameConfig.lock();
+	std::string modelsPath = readCfg->at("AssetPaths").at("modelsPath").as<std::string>();
+	cookedModelsPath = readCfg->at("AssetPaths").at("cookedModelsPath").as<std::string>();
+	loadThreads = readCfg->at("AssetPaths").at("modelLoadThreads").as<unsigned>();
+
+	if (!FindFBXNames(modelsPath.c_str(), _log))
+		return false;
+
+	std::vector<Model> cookedModels;
+	unsigned cookedCount = 0;
+	bool isCooked = LoadModels(modelsPath, cookedModels, cookedCount, _log);
+
+	_log.LogCategorized("MESSAGE", ("Cooked " + std::to_string(cookedCount) + " of " + std::to_string(fbxNames.size()) + " models, the rest were current.").c_str());
+	return isCooked;
+}
+
+// Loads every model in fbxNames into _outModels in the same order, spread over loadThreads.
+// Each model is loaded on its own, the only thing the threads share is the log.
+bool MAD::ModelLoader::LoadModels(const std::string& _fbxFolderPath, std::vector<Model>& _outModels, unsigned& _outCookedCount, GW::SYSTEM::GLog _log)
+{
+	auto loadStart = std::chrono::steady_clock::now();
+
+	UINT32 modelCount = (UINT32)fbxNames.size();
+	_outModels.clear();
+	_outModels.resize(modelCount);
+	std::vector<UCHAR> wasLoaded(modelCount, 0);
+	std::vector<UCHAR> wasCooked(modelCount, 0);
+
+	WorkerPool workerPool;
+	workerPool.Start(loadThreads);
+
+	// Models differ a lot in size, so rather than working through its own slice each thread takes the next model left
+	std::atomic<UINT32> nextModel(0);
+	workerPool.ParallelFor(modelCount, 1, [&](UINT32, UINT32, UINT32)
+		{
+			for (UINT32 i = nextModel++; i < modelCount; i = nextModel++)
+			{
+				bool isCooked = false;
+				wasLoaded[i] = LoadModel(_fbxFolderPath, fbxNames[i], _outModels[i], isCooked, _log);
+				wasCooked[i] = isCooked;
+			}
+		});
+
+	bool isLoaded = true;
+	_outCookedCount = 0;
+	for (UINT32 i = 0; i < modelCount; i++)
+	{
+		isLoaded = isLoaded && wasLoaded[i];
+		_outCookedCount += wasCooked[i];
+	}
+
+	double loadTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+	_log.LogCategorized("MESSAGE", ("Loaded " + std::to_string(modelCount) + " models on " + std::to_string(workerPool.GetThreadCount()) +
+		" threads in " + std::to_string(loadTime) + " ms").c_str());
+
+	return isLoaded;
+}
+
+// Reads the model's cooked file when it was cooked from the FBX as it is now. Otherwise the FBX is imported
+// and cooked again, which _outWasCooked reports.
+bool MAD::ModelLoader::LoadModel(const std::string& _fbxFolderPath, const std::string& _fbxName, Model& _outModel, bool& _outWasCooked, GW::SYSTEM::GLog _log)
+{
+	_outWasCooked = false;
+
+	// The cooked file is keyed by the FBX's contents, so touching a file without changing it doesn't cook it again
+	UINT32 sourceChecksum;
+	{
+		MappedFile fbxFile;
+		if (!fbxFile.Open(_fbxFolderPath + _fbxName))
+		{
+			_log.LogCategorized("ERROR", ("Couldn't open " + _fbxFolderPath + _fbxName).c_str());
+			return false;
+		}
+		sourceChecksum = CookedModel::GetSourceChecksum(fbxFile.GetData(), fbxFile.GetSize());
+	}
+
+	std::string cookedFilePath = GetCookedFilePath(_fbxName);
+	{
+		MappedFile cookedFile;
+		if (cookedFile.Open(cookedFilePath) &&
+			CookedModel::Read(cookedFile.GetData(), cookedFile.GetSize(), sourceChecksum, _outModel))
+		{
+			_outModel.modelName = _fbxName;
+			return true;
+		}
+	}
+
+	// A cooked file that failed part way may have filled some of it
+	_outModel = Model();
+	if (!_outModel.LoadModel(_fbxFolderPath, _fbxName))
+	{
+		_log.LogCategorized("ERROR", ("Couldn't import " + _fbxFolderPath + _fbxName).c_str());
+		return false;
+	}
+
+	_outWasCooked = CookModel(_outModel, sourceChecksum, cookedFilePath, _log);
+	return true;
+}
+
+bool MAD::ModelLoader::CookModel(const Model& _model, UINT32 _sourceChecksum, const std::string& _cookedFilePath, GW::SYSTEM::GLog _log)
+{
+	std::vector<UCHAR> cookedData;
+	CookedModel::Write(_model, _sourceChecksum, cookedData);
+
+	std::error_code error;
+	std::filesystem::create_directories(cookedModelsPath, error);
+
+	// A write cut short fails the checksum next time and is cooked again
+	std::ofstream cookedFile(_cookedFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+	cookedFile.write((const char*)cookedData.data(), cookedData.size());
+	if (!cookedFile)
+	{
+		_log.LogCategorized("ERROR", ("Couldn't write " + _cookedFilePath).c_str());
+		return false;
+	}
+
+	return true;
+}
+
+std::string MAD::ModelLoader::GetCookedFilePath(const std::string& _fbxName)
+{
+	return cookedModelsPath + std::filesystem::path(_fbxName).replace_extension(".madm").string();
+}
@@ -6,6 +6,7 @@
 #include <thread>
 #include "DelayLoad.h"
 #include "Model.h"
+#include "../Utils/WorkerPool.h"
 
 namespace MAD
 {
@@ -15,8 +16,17 @@ namespace MAD
 	{
 
 	private:		
+		// Cooked models are kept here, named after their FBX
+		std::string cookedModelsPath;
+		// Threads models are loaded on, 0 uses every core
+		UINT32 loadThreads;
+
 		bool FindFBXNames(const char* _fbxFolderPath, GW::SYSTEM::GLog log);
 		bool ReadFBXFiles(const char* _fbxFolderPath, GW::SYSTEM::GLog _log);
+		bool LoadModels(const std::string& _fbxFolderPath, std::vector<Model>& _outModels, unsigned& _outCookedCount, GW::SYSTEM::GLog _log);
+		bool LoadModel(const std::string& _fbxFolderPath, const std::string& _fbxName, Model& _outModel, bool& _outWasCooked, GW::SYSTEM::GLog _log);
+		bool CookModel(const Model& _model, UINT32 _sourceChecksum, const std::string& _cookedFilePath, GW::SYSTEM::GLog _log);
+		std::string GetCookedFilePath(const std::string& _fbxName);
 			
 	public:
 		std::vector<Model> models;
@@ -30,5 +40,7 @@ namespace MAD
 		ModelLoader();
 		~ModelLoader();
 		bool InitModels(std::weak_ptr<const GameConfig> _gameConfig, GW::SYSTEM::GLog _log);
+		// Cooks every FBX whose cooked model is missing or stale without keeping the models, for running headless
+		bool CookModels(std::weak_ptr<const GameConfig> _gameConfig, GW::SYSTEM::GLog _log);
 	};
 };
@@ -1,3 +1,5 @@
+#include <chrono>
+
 #include "SaveLoader.h"
 #include "../Entities/TileData.h"
 
@@ -10,6 +12,7 @@ bool SaveLoader::Init(std::weak_ptr<GameConfig> _gameConfig)
 
 	saveSlotsFolderPath = readCfg->at("SaveSlots").at("saveSlotsPath").as<std::string>();
 	saveSlotFilePath = saveSlotsFolderPath + readCfg->at("SaveSlots").at("saveSlotFileName").as<std::string>();
+	saveSlotWriter.Start(saveSlotFilePath, readCfg->at("SaveSlots").at("syncInterval").as<unsigned>());
 
 	if (!LoadSaveSlot())
 	{
@@ -23,14 +26,58 @@ bool SaveLoader::Init(std::weak_ptr<GameConfig> _gameConfig)
 	}
 
 	sceneFolderPath = readCfg->at("Scenes").at("scenesPath").as<std::string>();
+	sceneArchivePath = sceneFolderPath + readCfg->at("Scenes").at("sceneArchive").as<std::string>();
+	sceneJournalPath = sceneFolderPath + readCfg->at("Scenes").at("sceneJournal").as<std::string>();
+	sceneJournalMaxBytes = (size_t)readCfg->at("Scenes").at("sceneJournalMaxSize").as<unsigned>() * 1024;
+	sceneCodecFlags = 0;
+	if (readCfg->at("Scenes").at("sceneCodecRowRepeats").as<bool>())
+		sceneCodecFlags |= SCENE_CODEC_ROW_REPEATS;
+	if (readCfg->at("Scenes").at("sceneCodecBackReferences").as<bool>())
+		sceneCodecFlags |= SCENE_CODEC_BACK_REFERENCES;
+
+	bool logStats = readCfg->at("Physics").at("logStats").as<bool>();
+
+	auto loadStart = std::chrono::steady_clock::now();
+	if (LoadSceneArchive(GetSceneFilesFingerprint()))
+	{
+		LoadSceneJournal();
+		if (logStats)
+			std::cout << "Mapped " << scenes.size() << " scenes from " << sceneArchivePath << " in "
+				<< std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count() << " ms\n";
+
+		// Edits saved last session are folded into the archive and scene files so those stay current
+		if (sceneJournal.HasRecords())
+		{
+			std::cout << "Compacting " << sceneJournalPath << " (" << sceneJournal.GetSize() / 1024.0 << " KB) into " << sceneArchivePath << "\n";
+			CompactSceneJournal();
+		}
+	}
+	else if (LoadAllScenes())
+	{
+		if (logStats)
+			std::cout << "Loaded " << scenes.size() << " scene files in "
+				<< std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count() << " ms, packing them into "
+				<< sceneArchivePath << "\n";
+
+		// Edits journaled on top of a stale archive are replayed over the scene files, the chunks they saved win
+		// over the files' and the rest of the files is kept, so repacking doesn't drop them
+		if (sceneArchive.Open(sceneArchivePath) && LoadSceneJournal() && sceneJournal.HasRecords())
+			std::cout << "Replayed " << sceneJournalPath << " (" << sceneJournal.GetSize() / 1024.0 << " KB) over the changed scene files\n";
 
-	if (!LoadAllScenes())
+		CompactSceneJournal();
+	}
+	else
 	{
 		std::cout << "There is no level data yet\n";
 	}
 
 	return true;
 }
+
+void SaveLoader::Shutdown()
+{
+	saveSlotWriter.Stop();
+}
 #pragma endregion
 
 #pragma region Save Slot
@@ -39,10 +86,13 @@ bool MAD::SaveLoader::LoadSaveSlot()
 	std::vector<UCHAR> saveSlotData;
 	if (!ReadFile(saveSlotFilePath, saveSlotData))
 		return false;
-	if (saveSlotData.size() == 0)
+	if (saveSlotData.size() < SaveSlot::GetMembersSize())
 		return false;
 
 	std::memcpy(&saveSlot, &saveSlotData[0], SaveSlot::GetMembersSize());
+	if (saveSlotData.size() - SaveSlot::GetMembersSize() < saveSlot.strawberryCount * sizeof(USHORT))
+		return false;
+
 	saveSlot.strawberries.resize(saveSlot.strawberryCount);
 	if (saveSlot.strawberryCount > 0)
 		std::memcpy(
@@ -55,12 +105,16 @@ bool MAD::SaveLoader::LoadSaveSlot()
 
 bool MAD::SaveLoader::SaveSaveSlot()
 {
-	std::vector<UCHAR> saveSlotData;
+	saveSlotData.clear();
 	PushToBLOB(saveSlotData, &saveSlot, SaveSlot::GetMembersSize());
 	if (saveSlot.strawberryCount > 0)
 		PushToBLOB(saveSlotData, &saveSlot.strawberries[0], saveSlot.strawberryCount * sizeof(USHORT));
 
-	return WriteFile(saveSlotFilePath, saveSlotData);
+	if (!saveSlotWriter.IsRunning())
+		return WriteFile(saveSlotFilePath, saveSlotData);
+
+	saveSlotWriter.Submit(saveSlotData);
+	return true;
 }
 #pragma endregion
 
@@ -70,117 +124,430 @@ bool SaveLoader::LoadScene(std::string _sceneName, std::shared_ptr<Tilemap>& _ou
 	std::vector<UCHAR> sceneData;
 	if (!ReadFile(sceneFolderPath + _sceneName, sceneData))
 		return false;
-	if (sceneData.size() == 0)
+
+	return DecodeScene(sceneData.data(), sceneData.size(), _outTilemap);
+}
+
+bool SaveLoader::SaveScene(USHORT _sceneIndex)
+{
+	std::vector<UCHAR> sceneData;
+	EncodeScene(*GetScene(_sceneIndex), sceneData);
+
+	WriteFile(GetSceneFileName(_sceneIndex), sceneData);
+
+	return true;
+}
+
+
+void SaveLoader::SetTileCollisionClassifier(std::function<TileCollision(const TilemapTile&)> _getTileCollision)
+{
+	getTileCollision = _getTileCollision;
+
+	// Archived scenes build theirs when they're decoded
+	for (size_t i = 0; i < scenes.size(); i++)
+	{
+		if (isSceneDecoded[i])
+			scenes[i]->BuildCollisionBitmaps(getTileCollision);
+	}
+}
+
+bool SaveLoader::LoadAllScenes()
+{
+	std::vector<std::string> sceneNames;
+	if (!FindAllSceneNames(sceneNames))
 		return false;
 
-	int dataIndex = 0;
+	for (int i = 0; i < sceneNames.size(); i++)
+	{
+		std::shared_ptr<Tilemap> tilemap;
+		if (!LoadScene(sceneNames[i], tilemap))
+			return false;
 
-	// copy rows and columns
-	unsigned tilemapMembersSize = Tilemap::GetMembersSize();
-	Tilemap tilemap;
-	std::memcpy(&tilemap, &sceneData[dataIndex], tilemapMembersSize);
-	dataIndex += tilemapMembersSize;
-	_outTilemap = std::make_shared<Tilemap>(tilemap.originX, tilemap.originY, tilemap.rows, tilemap.columns);
+		scenes.push_back(tilemap);
+		isSceneDecoded.push_back(true);
+	}
 
-	// copy neighbor indices
-	UCHAR neighborCount;
-	std::memcpy(&neighborCount, &sceneData[dataIndex], sizeof(UCHAR));
-	dataIndex += sizeof(UCHAR);
-	_outTilemap->neighborScenes.resize(neighborCount);
-	for (int i = 0; i < neighborCount; i++)
+	RebuildSceneIndex();
+
+	return true;
+}
+
+// Only the header and table of contents are read, each scene starts as its bounds
+bool SaveLoader::LoadSceneArchive(UINT32 _sceneFilesFingerprint)
+{
+	if (!sceneArchive.Open(sceneArchivePath))
+		return false;
+
+	// Scene files pulled or edited by hand since the archive was packed win over it and whatever is journaled on top of it
+	if (sceneArchive.GetSourceFingerprint() != _sceneFilesFingerprint)
 	{
-		std::memcpy(&_outTilemap->neighborScenes[i], &sceneData[dataIndex], sizeof(USHORT));
-		dataIndex += sizeof(USHORT);
+		std::cout << "The scene files in " << sceneFolderPath << " changed since " << sceneArchivePath << " was packed\n";
+		sceneArchive.Close();
+		return false;
 	}
 
-	// copy all tiles
-	int curRow = 0, curCol = 0;
+	scenes.clear();
+	isSceneDecoded.assign(sceneArchive.GetSceneCount(), false);
+
+	for (UINT32 i = 0; i < sceneArchive.GetSceneCount(); i++)
+	{
+		const SceneArchiveEntry& entry = sceneArchive.GetEntry(i);
+
+		std::shared_ptr<Tilemap> scene = std::make_shared<Tilemap>();
+		scene->originX = entry.originX;
+		scene->originY = entry.originY;
+		scene->rows = entry.rows;
+		scene->columns = entry.columns;
+		scenes.push_back(scene);
+	}
+
+	RebuildSceneIndex();
+
+	return true;
+}
+
+bool SaveLoader::SaveSceneArchive()
+{
+	std::vector<SceneArchiveEntry> entries(scenes.size());
+	std::vector<std::vector<UCHAR>> payloads(scenes.size());
 
-	for (; dataIndex < sceneData.size(); dataIndex += sizeof(CompressedTile))
+	for (USHORT i = 0; i < scenes.size(); i++)
 	{
-		CompressedTile compressedTile;
-		std::memcpy(&compressedTile, &sceneData[dataIndex], sizeof(CompressedTile));
+		std::shared_ptr<Tilemap> scene = GetScene(i);
+		entries[i] = { 0, 0, 0, scene->originX, scene->originY, scene->rows, scene->columns };
+		EncodeScene(*scene, payloads[i]);
+	}
 
-		if (compressedTile.tilesetId == SPAWNPOINT_ID)
-			_outTilemap->AddSpawnpoint(curRow, curCol, compressedTile.orientationId);
+	std::vector<UCHAR> archiveData;
+	// Compaction writes the scene files first, so the archive's own edits don't leave it looking stale
+	SceneArchive::Pack(entries, payloads, GetSceneFilesFingerprint(), archiveData);
+
+	// Every scene is decoded by now, and the file can't be replaced while it's mapped
+	sceneArchive.Close();
+
+	if (!WriteFile(sceneArchivePath, archiveData))
+		return false;
+
+	// Mapped again so streamed scenes are decoded from their payloads instead of copied
+	sceneArchive.Open(sceneArchivePath);
+
+	// Everything in memory is in the archive now, so nothing is left for the journal
+	for (const std::shared_ptr<Tilemap>& scene : scenes)
+		scene->ClearDirtyChunks();
+	unsavedNeighborScenes.clear();
+	journaledSceneCount = scenes.size();
 
-		for (int i = 0; i < compressedTile.tileCount; i++)
+	return sceneJournal.Reset(sceneJournalPath, ((const SceneArchiveHeader*)archiveData.data())->tocChecksum);
+}
+
+// Applies the journal's records over the scenes just mapped from the archive
+bool SaveLoader::LoadSceneJournal()
+{
+	std::vector<UCHAR> records;
+	if (!sceneJournal.Open(sceneJournalPath, sceneArchive.GetTocChecksum(), records))
+		return false;
+
+	journaledSceneCount = scenes.size();
+	std::vector<USHORT> editedScenes;
+	bool isJournalValid = true;
+
+	SceneJournal::ForEachRecord(records, [&](const SceneJournalRecord& _record, const UCHAR* _data)
 		{
-			_outTilemap->tiles.at(curRow).at(curCol) = TilemapTile(compressedTile.tilesetId, compressedTile.orientationId);
+			if (!isJournalValid)
+				return;
 
-			curCol++;
-			if (curCol == _outTilemap->columns)
+			if (_record.type == JOURNAL_NEW_SCENE)
 			{
-				curCol = 0;
-				curRow++;
-				if (curRow == _outTilemap->rows)
-					return true;
+				INT32 bounds[4];
+				isJournalValid = _record.sceneIndex == scenes.size() && _record.size == sizeof(bounds);
+				if (!isJournalValid)
+					return;
+
+				std::memcpy(bounds, _data, sizeof(bounds));
+				AddNewScene(std::make_shared<Tilemap>(bounds[0], bounds[1], (UINT32)bounds[2], (UINT32)bounds[3]));
+				journaledSceneCount = scenes.size();
 			}
-		}
+			else
+			{
+				isJournalValid = _record.sceneIndex < scenes.size();
+				if (!isJournalValid)
+					return;
+
+				std::shared_ptr<Tilemap> scene = GetScene(_record.sceneIndex);
+				if (_record.type == JOURNAL_NEIGHBORS)
+				{
+					scene->neighborScenes.resize(_record.size / sizeof(USHORT));
+					if (!scene->neighborScenes.empty())
+						std::memcpy(scene->neighborScenes.data(), _data, scene->neighborScenes.size() * sizeof(USHORT));
+				}
+				else
+				{
+					isJournalValid = _record.type == JOURNAL_CHUNK && DecodeChunk(_data, _record.size, *scene);
+				}
+			}
+
+			if (std::find(editedScenes.begin(), editedScenes.end(), _record.sceneIndex) == editedScenes.end())
+				editedScenes.push_back(_record.sceneIndex);
+		});
+
+	if (!isJournalValid)
+		std::cout << sceneJournalPath << " has a record that doesn't fit " << sceneArchivePath << ", the records after it were skipped\n";
+
+	for (USHORT sceneIndex : editedScenes)
+	{
+		std::shared_ptr<Tilemap> scene = scenes[sceneIndex];
+		scene->CompactChunks();
+
+		// Spawnpoints come from the tiles, and the journal may have added or removed some
+		scene->spawnpoints.clear();
+		AddTileSpawnpoints(*scene);
+
+		if (getTileCollision)
+			scene->BuildCollisionBitmaps(getTileCollision);
+
+		if (std::find(staleSceneFiles.begin(), staleSceneFiles.end(), sceneIndex) == staleSceneFiles.end())
+			staleSceneFiles.push_back(sceneIndex);
 	}
 
 	return true;
 }
 
-bool SaveLoader::SaveScene(USHORT _sceneIndex)
+// Only what changed since the last save is appended, a one tile edit costs one chunk record
+bool SaveLoader::SaveSceneChanges()
 {
-	std::shared_ptr<Tilemap> tilemap = scenes.at(_sceneIndex);
-	std::vector<UCHAR> sceneData;
+	std::vector<UCHAR> recordData;
 
-	// push rows and column data
-	PushToBLOB(sceneData, tilemap.get(), Tilemap::GetMembersSize());
+	for (size_t i = 0; i < scenes.size(); i++)
+	{
+		if (!isSceneDecoded[i])
+			continue;
 
-	// push neighbor indices
-	UCHAR neighborCount = (UCHAR)tilemap->neighborScenes.size();
-	PushToBLOB(sceneData, &neighborCount, sizeof(UCHAR));
-	for (int i = 0; i < neighborCount; i++)
-		PushToBLOB(sceneData, &tilemap->neighborScenes[i], sizeof(USHORT));
+		USHORT sceneIndex = (USHORT)i;
+		Tilemap& scene = *scenes[i];
+		bool isNewScene = i >= journaledSceneCount;
+		bool areNeighborsUnsaved = std::find(unsavedNeighborScenes.begin(), unsavedNeighborScenes.end(), sceneIndex) != unsavedNeighborScenes.end();
 
-	// push tile data 
-	CompressedTile compressedTile;
+		if (!isNewScene && !areNeighborsUnsaved && scene.dirtyChunks.empty())
+			continue;
 
-	for (int row = 0; row < tilemap->rows; row++)
-	{
-		for (int col = 0; col < tilemap->columns; col++)
+		if (isNewScene)
 		{
-			if (!compressedTile.Equals(tilemap->tiles.at(row).at(col)) || compressedTile.tileCount == UCHAR_MAX)
-			{
-				if (compressedTile.tileCount > 0)
-					PushToBLOB(sceneData, &compressedTile, sizeof(CompressedTile));
+			INT32 bounds[4] = { scene.originX, scene.originY, (INT32)scene.rows, (INT32)scene.columns };
+			recordData.assign((const UCHAR*)bounds, (const UCHAR*)bounds + sizeof(bounds));
+			sceneJournal.Append(JOURNAL_NEW_SCENE, sceneIndex, recordData);
 
-				compressedTile = CompressedTile(tilemap->tiles.at(row).at(col));
+			// A new scene's chunks all start out empty, so only the ones that aren't anymore are saved
+			for (UINT32 chunkIndex = 0; chunkIndex < scene.chunks.size(); chunkIndex++)
+			{
+				if (!scene.chunks[chunkIndex].IsEmpty() && !scene.isChunkDirty[chunkIndex])
+				{
+					EncodeChunk(scene, chunkIndex, recordData);
+					sceneJournal.Append(JOURNAL_CHUNK, sceneIndex, recordData);
+				}
 			}
+		}
+
+		if (isNewScene || areNeighborsUnsaved)
+		{
+			recordData.assign((const UCHAR*)scene.neighborScenes.data(), (const UCHAR*)(scene.neighborScenes.data() + scene.neighborScenes.size()));
+			sceneJournal.Append(JOURNAL_NEIGHBORS, sceneIndex, recordData);
+		}
 
-			compressedTile.tileCount++;
+		for (UINT32 chunkIndex : scene.dirtyChunks)
+		{
+			EncodeChunk(scene, chunkIndex, recordData);
+			sceneJournal.Append(JOURNAL_CHUNK, sceneIndex, recordData);
 		}
+		scene.ClearDirtyChunks();
+
+		if (std::find(staleSceneFiles.begin(), staleSceneFiles.end(), sceneIndex) == staleSceneFiles.end())
+			staleSceneFiles.push_back(sceneIndex);
 	}
 
-	if (compressedTile.tileCount > 0)
-		PushToBLOB(sceneData, &compressedTile, sizeof(CompressedTile));
+	journaledSceneCount = scenes.size();
+	unsavedNeighborScenes.clear();
 
-	WriteFile(GetSceneFileName(_sceneIndex), sceneData);
+	if (!sceneJournal.Commit())
+	{
+		std::cout << "Couldn't append to " << sceneJournalPath << ", rewriting " << sceneArchivePath << " instead\n";
+		return CompactSceneJournal();
+	}
+
+	if (sceneJournal.GetSize() > sceneJournalMaxBytes)
+		return CompactSceneJournal();
 
 	return true;
 }
 
+// Writes every scene's file and the archive from memory, which has every journaled edit in it
+bool SaveLoader::CompactSceneJournal()
+{
+	for (USHORT sceneIndex : staleSceneFiles)
+		SaveScene(sceneIndex);
+	staleSceneFiles.clear();
+
+	return SaveSceneArchive();
+}
 
-bool SaveLoader::LoadAllScenes()
+// Scenes saved since the SceneCodec header are decoded by it, older Scene*.txt files and archives by DecodeLegacyScene
+bool SaveLoader::DecodeScene(const UCHAR* _data, size_t _dataSize, std::shared_ptr<Tilemap>& _outTilemap) const
 {
-	std::vector<std::string> sceneNames;
-	if (!FindAllSceneNames(sceneNames))
+	if (SceneCodec::IsEncoded(_data, _dataSize))
+	{
+		if (!SceneCodec::Decode(_data, _dataSize, _outTilemap))
+			return false;
+
+		AddTileSpawnpoints(*_outTilemap);
+	}
+	else if (!DecodeLegacyScene(_data, _dataSize, _outTilemap))
+	{
 		return false;
+	}
 
-	for (int i = 0; i < sceneNames.size(); i++)
+	if (getTileCollision)
+		_outTilemap->BuildCollisionBitmaps(getTileCollision);
+
+	return true;
+}
+
+// Reads the per scene file format from before SceneCodec: origin, rows and columns, the neighbour indices, then runs of tiles.
+// Runs are filled a chunk's row at a time straight from _data, chunks that stay a single tile take no tile memory.
+bool SaveLoader::DecodeLegacyScene(const UCHAR* _data, size_t _dataSize, std::shared_ptr<Tilemap>& _outTilemap) const
+{
+	unsigned tilemapMembersSize = Tilemap::GetMembersSize();
+	if (_dataSize < tilemapMembersSize + sizeof(UCHAR))
+		return false;
+
+	size_t dataIndex = 0;
+
+	// copy rows and columns
+	INT32 originX, originY;
+	UINT32 rows, columns;
+	std::memcpy(&originX, &_data[dataIndex], sizeof(INT32));
+	std::memcpy(&originY, &_data[dataIndex + sizeof(INT32)], sizeof(INT32));
+	std::memcpy(&rows, &_data[dataIndex + sizeof(INT32) * 2], sizeof(UINT32));
+	std::memcpy(&columns, &_data[dataIndex + sizeof(INT32) * 2 + sizeof(UINT32)], sizeof(UINT32));
+	dataIndex += tilemapMembersSize;
+	_outTilemap = std::make_shared<Tilemap>(originX, originY, rows, columns);
+
+	// copy neighbor indices
+	UCHAR neighborCount = _data[dataIndex];
+	dataIndex += sizeof(UCHAR);
+	if (_dataSize - dataIndex < neighborCount * sizeof(USHORT))
+		return false;
+
+	_outTilemap->neighborScenes.resize(neighborCount);
+	if (neighborCount > 0)
+		std::memcpy(_outTilemap->neighborScenes.data(), &_data[dataIndex], neighborCount * sizeof(USHORT));
+	dataIndex += neighborCount * sizeof(USHORT);
+
+	// copy all tiles
+	const CompressedTile* compressedTiles = (const CompressedTile*)&_data[dataIndex];
+	size_t compressedCount = (_dataSize - dataIndex) / sizeof(CompressedTile);
+	UINT32 curRow = 0, curCol = 0;
+
+	for (size_t i = 0; i < compressedCount && curRow < rows && columns > 0; i++)
 	{
-		std::shared_ptr<Tilemap> tilemap;
-		if (!LoadScene(sceneNames[i], tilemap))
-			return false;
+		const CompressedTile& compressedTile = compressedTiles[i];
+		TilemapTile tile(compressedTile.tilesetId, compressedTile.orientationId);
 
-		scenes.push_back(tilemap);
+		if (compressedTile.tilesetId == SPAWNPOINT_ID)
+			_outTilemap->AddSpawnpoint(curRow, curCol, compressedTile.orientationId);
+
+		UINT32 tileCount = compressedTile.tileCount;
+		while (tileCount > 0 && curRow < rows)
+		{
+			UINT32 runLength = min(tileCount, columns - curCol);
+			_outTilemap->FillRow(curRow, curCol, runLength, tile);
+			tileCount -= runLength;
+
+			curCol += runLength;
+			if (curCol == columns)
+			{
+				curCol = 0;
+				curRow++;
+			}
+		}
 	}
 
+	_outTilemap->CompactChunks();
+
 	return true;
 }
+
+void SaveLoader::AddTileSpawnpoints(Tilemap& _tilemap) const
+{
+	_tilemap.ForEachTile([&_tilemap](UINT32 _row, UINT32 _col, const TilemapTile& _tile)
+		{
+			if (_tile.tilesetId == SPAWNPOINT_ID)
+				_tilemap.AddSpawnpoint(_row, _col, _tile.orientationId);
+		});
+}
+
+void SaveLoader::EncodeScene(const Tilemap& _tilemap, std::vector<UCHAR>& _outData)
+{
+	SceneCodec::Encode(_tilemap, sceneCodecFlags, _outData);
+}
+
+void SaveLoader::EncodeChunk(const Tilemap& _tilemap, UINT32 _chunkIndex, std::vector<UCHAR>& _outData)
+{
+	SceneCodec::EncodeChunk(_tilemap, _chunkIndex, sceneCodecFlags, _outData);
+}
+
+bool SaveLoader::DecodeChunk(const UCHAR* _data, size_t _dataSize, Tilemap& _tilemap)
+{
+	return SceneCodec::DecodeChunk(_data, _dataSize, _tilemap);
+}
+
+// A payload that fails its checksum leaves an empty scene of the same bounds
+void SaveLoader::DecodeArchivedScene(USHORT _sceneIndex)
+{
+	isSceneDecoded[_sceneIndex] = true;
+
+	size_t payloadSize = 0;
+	const UCHAR* payload = sceneArchive.GetPayload(_sceneIndex, payloadSize);
+
+	std::shared_ptr<Tilemap> tilemap;
+	if (payload == nullptr || !DecodeScene(payload, payloadSize, tilemap))
+	{
+		std::cout << "Scene " << _sceneIndex << " in " << sceneArchivePath << " is corrupt\n";
+
+		const SceneArchiveEntry& entry = sceneArchive.GetEntry(_sceneIndex);
+		tilemap = std::make_shared<Tilemap>(entry.originX, entry.originY, entry.rows, entry.columns);
+		if (getTileCollision)
+			tilemap->BuildCollisionBitmaps(getTileCollision);
+	}
+
+	scenes[_sceneIndex] = tilemap;
+}
+
+// Undecoded scenes, and decoded ones with nothing changed since the archive was packed
+bool SaveLoader::IsSceneArchived(USHORT _sceneIndex)
+{
+	if (!isSceneDecoded[_sceneIndex])
+		return true;
+
+	return sceneArchive.IsOpen() && _sceneIndex < sceneArchive.GetSceneCount() &&
+		scenes[_sceneIndex]->dirtyChunks.empty() &&
+		std::find(staleSceneFiles.begin(), staleSceneFiles.end(), _sceneIndex) == staleSceneFiles.end() &&
+		std::find(unsavedNeighborScenes.begin(), unsavedNeighborScenes.end(), _sceneIndex) == unsavedNeighborScenes.end();
+}
+
+// Bounds cover [origin, origin + size) like Tilemap::IsPointInside
+void SaveLoader::IndexScene(USHORT _sceneIndex)
+{
+	const Tilemap& scene = *scenes[_sceneIndex];
+	sceneGrid.Insert(_sceneIndex, (float)scene.originX, (float)scene.originY,
+		(float)scene.originX + scene.columns, (float)scene.originY + scene.rows);
+}
+
+void SaveLoader::RebuildSceneIndex()
+{
+	sceneGrid.SetCellSize(SCENE_GRID_CELL_SIZE);
+
+	for (USHORT i = 0; i < scenes.size(); i++)
+		IndexScene(i);
+}
 #pragma endregion
 
 #pragma region Private Helpers
@@ -214,6 +581,27 @@ std::string MAD::SaveLoader::GetSceneFileName(int _sceneIndex)
 	return sceneFolderPath + "Scene" + std::to_string(_sceneIndex) + ".txt";
 }
 
+// Only listed and not read, so checking the archive against the scene files stays cheap
+UINT32 MAD::SaveLoader::GetSceneFilesFingerprint()
+{
+	std::vector<std::string> sceneNames;
+	FindAllSceneNames(sceneNames);
+
+	std::vector<UCHAR> fileStats;
+	for (const std::string& sceneName : sceneNames)
+	{
+		std::error_code error;
+		UINT64 fileSize = std::filesystem::file_size(sceneFolderPath + sceneName, error);
+		INT64 writeTime = std::filesystem::last_write_time(sceneFolderPath + sceneName, error).time_since_epoch().count();
+
+		PushToBLOB(fileStats, sceneName.data(), (unsigned)sceneName.size() + 1);
+		PushToBLOB(fileStats, &fileSize, sizeof(fileSize));
+		PushToBLOB(fileStats, &writeTime, sizeof(writeTime));
+	}
+
+	return SceneArchive::Checksum(fileStats.data(), fileStats.size());
+}
+
 void MAD::SaveLoader::PushToBLOB(std::vector<UCHAR>& _blob, const void* data, unsigned dataSize)
 {
 	size_t blobSize = _blob.size();
@@ -230,7 +618,7 @@ bool MAD::SaveLoader::WriteFile(std::string _fileName, const std::vector<UCHAR>&
 	if (!file)
 		return false;
 
-	std::copy(_inData.cbegin(), _inData.cend(), std::ostream_iterator<UCHAR>(file));
+	file.write((const char*)_inData.data(), _inData.size());
 
 	file.close();
 
@@ -263,53 +651,61 @@ bool MAD::SaveLoader::ReadFile(std::string _fileName, std::vector<UCHAR>& _outDa
 #pragma region Public Helpers
 USHORT MAD::SaveLoader::AddNewScene(std::shared_ptr<Tilemap> _scene)
 {
+	if (getTileCollision)
+		_scene->BuildCollisionBitmaps(getTileCollision);
+
 	scenes.push_back(_scene);
+	isSceneDecoded.push_back(true);
+	IndexScene((USHORT)(scenes.size() - 1));
 
 	return (USHORT)(scenes.size() - 1);
 }
 
 void MAD::SaveLoader::AddSceneNeighbor(USHORT _scene1Index, USHORT _scene2Index)
 {
-	std::shared_ptr<Tilemap> scene1 = scenes[_scene1Index];
-	std::shared_ptr<Tilemap> scene2 = scenes[_scene2Index];
+	std::shared_ptr<Tilemap> scene1 = GetScene(_scene1Index);
+	std::shared_ptr<Tilemap> scene2 = GetScene(_scene2Index);
 
 	if (std::find(scene1->neighborScenes.begin(), scene1->neighborScenes.end(), _scene2Index) == scene1->neighborScenes.end())
+	{
 		scene1->neighborScenes.push_back(_scene2Index);
+		LogNeighborChange(_scene1Index);
+	}
 	if (std::find(scene2->neighborScenes.begin(), scene2->neighborScenes.end(), _scene1Index) == scene2->neighborScenes.end())
+	{
 		scene2->neighborScenes.push_back(_scene1Index);
+		LogNeighborChange(_scene2Index);
+	}
 }
 
 void MAD::SaveLoader::RemoveSceneNeighbor(USHORT _scene1Index, USHORT _scene2Index)
 {
-	std::shared_ptr<Tilemap> scene1 = scenes[_scene1Index];
-	std::shared_ptr<Tilemap> scene2 = scenes[_scene2Index];
+	std::shared_ptr<Tilemap> scene1 = GetScene(_scene1Index);
+	std::shared_ptr<Tilemap> scene2 = GetScene(_scene2Index);
 
 	// if either scene still has a scene exit containing the other, they are not unlinked as neighbors
-	for (int row = 0; row < scene1->tiles.size(); row++)
-	{
-		for (int col = 0; col < scene1->tiles[row].size(); col++)
-		{
-			if (scene1->tiles.at(row).at(col).tilesetId == SCENE_EXIT_ID &&
-				scene1->tiles.at(row).at(col).orientationId == _scene2Index)
-				return;
-		}
-	}
-	for (int row = 0; row < scene2->tiles.size(); row++)
-	{
-		for (int col = 0; col < scene2->tiles[row].size(); col++)
-		{
-			if (scene2->tiles.at(row).at(col).tilesetId == SCENE_EXIT_ID &&
-				scene2->tiles.at(row).at(col).orientationId == _scene1Index)
-				return;
-		}
-	}
+	if (scene1->AnyTile([_scene2Index](const TilemapTile& _tile) { return _tile.tilesetId == SCENE_EXIT_ID && _tile.orientationId == _scene2Index; }) ||
+		scene2->AnyTile([_scene1Index](const TilemapTile& _tile) { return _tile.tilesetId == SCENE_EXIT_ID && _tile.orientationId == _scene1Index; }))
+		return;
 
 	auto scene1Neighbor = std::find(scene1->neighborScenes.begin(), scene1->neighborScenes.end(), _scene2Index);
 	auto scene2Neighbor = std::find(scene2->neighborScenes.begin(), scene2->neighborScenes.end(), _scene1Index);
 	if (scene1Neighbor != scene1->neighborScenes.end())
+	{
 		scene1->neighborScenes.erase(scene1Neighbor);
+		LogNeighborChange(_scene1Index);
+	}
 	if (scene2Neighbor != scene2->neighborScenes.end())
+	{
 		scene2->neighborScenes.erase(scene2Neighbor);
+		LogNeighborChange(_scene2Index);
+	}
+}
+
+void MAD::SaveLoader::LogNeighborChange(USHORT _sceneIndex)
+{
+	if (std::find(unsavedNeighborScenes.begin(), unsavedNeighborScenes.end(), _sceneIndex) == unsavedNeighborScenes.end())
+		unsavedNeighborScenes.push_back(_sceneIndex);
 }
 
 void MAD::SaveLoader::EnterScene(USHORT _sceneIndex, USHORT _prevSceneIndex)
@@ -352,12 +748,64 @@ std::shared_ptr<Tilemap> MAD::SaveLoader::GetScene(USHORT _sceneIndex)
 	if (scenes.size() <= _sceneIndex)
 		return NULL;
 
+	if (!isSceneDecoded[_sceneIndex])
+		DecodeArchivedScene(_sceneIndex);
+
 	return scenes.at(_sceneIndex);
 }
 
+// The payload is copied rather than pointed at, the archive is unmapped when it's rewritten and the worker may still be decoding
+SceneSource MAD::SaveLoader::GetSceneSource(USHORT _sceneIndex)
+{
+	SceneSource source;
+	if (scenes.size() <= _sceneIndex)
+		return source;
+
+	if (IsSceneArchived(_sceneIndex))
+	{
+		size_t payloadSize = sceneArchive.GetEntry(_sceneIndex).size;
+		const UCHAR* payload = sceneArchive.GetUncheckedPayload(_sceneIndex);
+
+		source.payload = std::make_shared<const std::vector<UCHAR>>(payload, payload + payloadSize);
+		source.payloadChecksum = sceneArchive.GetEntry(_sceneIndex).checksum;
+	}
+	else
+	{
+		source.scene = std::make_shared<const Tilemap>(*scenes[_sceneIndex]);
+	}
+
+	return source;
+}
+
+std::shared_ptr<Tilemap> MAD::SaveLoader::DecodeSceneSource(const SceneSource& _source) const
+{
+	if (_source.payload == nullptr ||
+		SceneArchive::Checksum(_source.payload->data(), _source.payload->size()) != _source.payloadChecksum)
+		return nullptr;
+
+	std::shared_ptr<Tilemap> tilemap;
+	if (!DecodeScene(_source.payload->data(), _source.payload->size(), tilemap))
+		return nullptr;
+
+	return tilemap;
+}
+
+void MAD::SaveLoader::AdoptDecodedScene(USHORT _sceneIndex, std::shared_ptr<Tilemap> _scene)
+{
+	if (_scene == nullptr || scenes.size() <= _sceneIndex || isSceneDecoded[_sceneIndex])
+		return;
+
+	scenes[_sceneIndex] = _scene;
+	isSceneDecoded[_sceneIndex] = true;
+}
+
 int MAD::SaveLoader::GetSceneAtPoint(GW::MATH::GVECTORF _point)
 {
-	for (int i = 0; i < scenes.size(); i++)
+	sceneGridResults.clear();
+	sceneGrid.Query(_point.x, _point.y, _point.x, _point.y, sceneGridResults);
+
+	// Results are in index order, so overlapping scenes resolve to the lowest index as before
+	for (USHORT i : sceneGridResults)
 	{
 		if (scenes[i]->IsPointInside(_point))
 		{
@@ -398,6 +846,21 @@ void MAD::SaveLoader::GetScenesAroundPoint(GW::MATH::GVECTORF _point, std::vecto
 		_outSceneIndices.push_back(sceneIndex);
 }
 
+void MAD::SaveLoader::GetScenesInRect(float _minX, float _minY, float _maxX, float _maxY, std::vector<USHORT>& _outSceneIndices)
+{
+	size_t startSize = _outSceneIndices.size();
+	sceneGrid.Query(_minX, _minY, _maxX, _maxY, _outSceneIndices);
+
+	auto outside = std::remove_if(_outSceneIndices.begin() + startSize, _outSceneIndices.end(),
+		[this, _minX, _minY, _maxX, _maxY](USHORT _sceneIndex)
+		{
+			const Tilemap& scene = *scenes[_sceneIndex];
+			return _maxX < scene.originX || _minX >= scene.originX + (float)scene.columns ||
+				_maxY < scene.originY || _minY >= scene.originY + (float)scene.rows;
+		});
+	_outSceneIndices.erase(outside, _outSceneIndices.end());
+}
+
 bool MAD::SaveLoader::GetClosestTilePosOfScene(
 	GW::MATH::GVECTORF _point,
 	USHORT _sceneIndex,
@@ -10,6 +10,14 @@
 #include "../Components/Tilemaps.h"
 #include "../Components/SaveSlot.h"
 
+#include "SceneArchive.h"
+#include "SaveSlotWriter.h"
+#include "SceneJournal.h"
+#include "SceneCodec.h"
+#include "SceneStreamer.h"
+
+#include "../Utils/SpatialGrid.h"
+
 // This reads .h2b files (which are optimized binary .obj+.mtl files) for actor game objects.
 namespace MAD
 {
@@ -19,27 +27,85 @@ namespace MAD
 		std::string saveSlotsFolderPath;
 		std::string saveSlotFilePath;
 		std::string sceneFolderPath;
+		std::string sceneArchivePath;
+		std::string sceneJournalPath;
 		
 		std::vector<std::shared_ptr<Tilemap>> scenes;
+		// Scenes mapped from the archive only have their bounds until GetScene decodes them
+		SceneArchive sceneArchive;
+		std::vector<bool> isSceneDecoded;
+
+		// Scene edits saved since the archive was last written, it's folded back in once it's past sceneJournalMaxBytes
+		SceneJournal sceneJournal;
+		size_t sceneJournalMaxBytes = 0;
+		// SceneCodecFlags for the ops EncodeScene looks for
+		UINT32 sceneCodecFlags = 0;
+		// Scenes from this index on were added since the last save
+		size_t journaledSceneCount = 0;
+		std::vector<USHORT> unsavedNeighborScenes;
+		// Scenes whose Scene*.txt is behind the journal
+		std::vector<USHORT> staleSceneFiles;
+
+		// Scene indices by the world cells their bounds cover, so point and area lookups only test nearby scenes
+		static constexpr float SCENE_GRID_CELL_SIZE = 32;
+		SpatialGrid<USHORT> sceneGrid;
+		std::vector<USHORT> sceneGridResults;
 		std::vector<std::vector<USHORT>> sceneConnections;
 
 		SaveSlot saveSlot;
+		// Saves are encoded here on the game thread and written by saveSlotWriter
+		SaveSlotWriter saveSlotWriter;
+		std::vector<UCHAR> saveSlotData;
+
+		// Decides what goes in each scene's collision bitmaps, needs the tile prefabs so it's set after Init
+		std::function<TileCollision(const TilemapTile&)> getTileCollision;
 
 	public:
 		bool Init(std::weak_ptr<GameConfig> _gameConfig);
+		// Writes out any save still waiting on the save slot writer
+		void Shutdown();
 
 		bool LoadSaveSlot();
+		// Hands the save slot to the save slot writer, it's on disk some time after this returns
 		bool SaveSaveSlot();
 
 		bool LoadScene(std::string _sceneName, std::shared_ptr<Tilemap>& _outTilemap);
 		bool SaveScene(USHORT _sceneIndex);
 		bool LoadAllScenes();
 
+		// Fails if the archive is missing, damaged or wasn't packed alongside the scene files with _sceneFilesFingerprint
+		bool LoadSceneArchive(UINT32 _sceneFilesFingerprint);
+		// Packs every scene into the archive, the per scene files are converted by loading them first
+		bool SaveSceneArchive();
+		// Appends the chunks, neighbour lists and scenes changed since the last save to the scene journal
+		bool SaveSceneChanges();
+
+		// Builds the collision bitmaps of every loaded scene and of scenes loaded or added from now on.
+		// Scenes are decoded on SceneStreamer's thread too, so _getTileCollision must be safe to call from it.
+		void SetTileCollisionClassifier(std::function<TileCollision(const TilemapTile&)> _getTileCollision);
+
 	private:
 		bool FindAllSceneNames(std::vector<std::string>& _sceneNames);
 		std::string GetSceneFileName(int _sceneIndex);
+		UINT32 GetSceneFilesFingerprint();
 		void PushToBLOB(std::vector<UCHAR>& _blob, const void* data, unsigned dataSize);
 
+		bool DecodeScene(const UCHAR* _data, size_t _dataSize, std::shared_ptr<Tilemap>& _outTilemap) const;
+		bool DecodeLegacyScene(const UCHAR* _data, size_t _dataSize, std::shared_ptr<Tilemap>& _outTilemap) const;
+		void AddTileSpawnpoints(Tilemap& _tilemap) const;
+		void EncodeScene(const Tilemap& _tilemap, std::vector<UCHAR>& _outData);
+		void DecodeArchivedScene(USHORT _sceneIndex);
+		bool IsSceneArchived(USHORT _sceneIndex);
+
+		bool LoadSceneJournal();
+		bool CompactSceneJournal();
+		void EncodeChunk(const Tilemap& _tilemap, UINT32 _chunkIndex, std::vector<UCHAR>& _outData);
+		bool DecodeChunk(const UCHAR* _data, size_t _dataSize, Tilemap& _tilemap);
+
+		void LogNeighborChange(USHORT _sceneIndex);
+		void IndexScene(USHORT _sceneIndex);
+		void RebuildSceneIndex();
+
 		bool WriteFile(std::string _fileName, const std::vector<UCHAR>& _inData);
 		bool ReadFile(std::string _fileName, std::vector<UCHAR>& _outData);
 
@@ -53,11 +119,20 @@ namespace MAD
 		void CollectStrawberry(USHORT _sceneIndex);
 		void ResetSaveData();
 
+		// Scenes that haven't been through GetScene may only have their bounds, no tiles or collision bitmaps
 		const std::vector<std::shared_ptr<Tilemap>>& GetAllScenes();
 		std::shared_ptr<Tilemap> GetScene(USHORT _sceneIndex);
+		// What SceneStreamer prepares the scene from, only scenes edited since the archive was packed are copied here
+		SceneSource GetSceneSource(USHORT _sceneIndex);
+		// Safe to call from any thread, null if the payload is corrupt
+		std::shared_ptr<Tilemap> DecodeSceneSource(const SceneSource& _source) const;
+		// Keeps a scene decoded off the game thread, unless GetScene decoded it in the meantime
+		void AdoptDecodedScene(USHORT _sceneIndex, std::shared_ptr<Tilemap> _scene);
 		// returns -1 if it doesn't collide, otherwise returns the scene's index
 		int GetSceneAtPoint(GW::MATH::GVECTORF _point);
 		void GetScenesAroundPoint(GW::MATH::GVECTORF _point, std::vector<USHORT>& _outSceneIndices);
+		// Appends every scene whose bounds overlap the world rectangle, in index order
+		void GetScenesInRect(float _minX, float _minY, float _maxX, float _maxY, std::vector<USHORT>& _outSceneIndices);
 		bool GetClosestTilePosOfScene(
 			GW::MATH::GVECTORF _point, 
 			USHORT _sceneIndex, 
@@ -0,0 +1,383 @@
+// Checks and timings for the save files, run by --test-saves on generated scenes in a scratch folder
+#ifndef SAVELOADERTESTS_H
+#define SAVELOADERTESTS_H
+
+#include <chrono>
+#include <cstddef>
+#include <random>
+
+#include "SaveLoader.h"
+
+namespace MAD
+{
+	class SaveLoaderTests
+	{
+		std::shared_ptr<GameConfig> gameConfig;
+		std::string folderPath;
+
+	public:
+		// Points the config's scene and save slot folders at a scratch folder while the tests run, returns false if any fail
+		bool Run(std::shared_ptr<GameConfig> _gameConfig, unsigned _sceneCount)
+		{
+			gameConfig = _gameConfig;
+			folderPath = "../SaveLoaderTests/";
+
+			std::string scenesPath = (*gameConfig)["Scenes"]["scenesPath"].as<std::string>();
+			std::string saveSlotsPath = (*gameConfig)["SaveSlots"]["saveSlotsPath"].as<std::string>();
+			(*gameConfig)["Scenes"]["scenesPath"] = folderPath;
+			(*gameConfig)["SaveSlots"]["saveSlotsPath"] = folderPath;
+
+			bool isPassing = BenchmarkSceneLoads(_sceneCount);
+			isPassing = TestSaveSlotCrashes(50) && isPassing;
+			isPassing = TestSceneCodecRoundTrips(2000) && isPassing;
+			isPassing = BenchmarkSceneDecodes(_sceneCount) && isPassing;
+
+			// The config is saved when it's destroyed, it shouldn't keep the scratch folder
+			(*gameConfig)["Scenes"]["scenesPath"] = scenesPath;
+			(*gameConfig)["SaveSlots"]["saveSlotsPath"] = saveSlotsPath;
+			std::filesystem::remove_all(folderPath);
+
+			std::cout << (isPassing ? "Save tests passed\n" : "Save tests failed\n");
+			return isPassing;
+		}
+
+		// Run in a child process by TestSaveSlotCrashes, saves as fast as it can until the process is killed.
+		// Each save is a count then that many USHORTs set to the count, so a torn one can be told apart.
+		static void WriteSaveSlotsUntilKilled(const std::string& _filePath)
+		{
+			SaveSlotWriter writer;
+			writer.Start(_filePath, 0);
+
+			std::vector<UCHAR> data;
+			for (UINT32 i = 1; ; i++)
+			{
+				UINT32 count = i % 4096;
+				data.resize(sizeof(UINT32) + count * sizeof(USHORT));
+				std::memcpy(data.data(), &count, sizeof(UINT32));
+				for (UINT32 j = 0; j < count; j++)
+					std::memcpy(&data[sizeof(UINT32) + j * sizeof(USHORT)], &count, sizeof(USHORT));
+
+				writer.Submit(data);
+			}
+		}
+
+	private:
+		// Kills a process saving the slot at random points, the slot it leaves must be a whole save, the old one or the new one
+		bool TestSaveSlotCrashes(unsigned _kills)
+		{
+			char exePath[MAX_PATH];
+			GetModuleFileNameA(NULL, exePath, MAX_PATH);
+
+			std::string filePath = folderPath + "saveSlot.txt";
+			std::string commandLine = std::string("\"") + exePath + "\" --write-save-slots \"" + filePath + "\"";
+			std::filesystem::create_directories(folderPath);
+			std::filesystem::remove(filePath);
+
+			std::mt19937 random(_kills);
+			unsigned savesFound = 0;
+
+			for (unsigned i = 0; i < _kills; i++)
+			{
+				STARTUPINFOA startupInfo = {};
+				startupInfo.cb = sizeof(startupInfo);
+				PROCESS_INFORMATION processInfo = {};
+				std::vector<char> commandLineBuffer(commandLine.begin(), commandLine.end());
+				commandLineBuffer.push_back('\0');
+
+				if (!CreateProcessA(NULL, commandLineBuffer.data(), NULL, NULL, FALSE, CREATE_NO_WINDOW, NULL, NULL, &startupInfo, &processInfo))
+				{
+					std::cout << "Couldn't start " << exePath << " to kill while it saves\n";
+					return false;
+				}
+
+				Sleep(100 + random() % 200);
+				TerminateProcess(processInfo.hProcess, 1);
+				WaitForSingleObject(processInfo.hProcess, INFINITE);
+				CloseHandle(processInfo.hThread);
+				CloseHandle(processInfo.hProcess);
+
+				// Only the first kills may land before anything was saved
+				if (!std::filesystem::exists(filePath) && savesFound == 0)
+					continue;
+
+				if (!IsSaveSlotWhole(filePath))
+				{
+					std::cout << "Killing the save slot writer left " << filePath << " torn, on kill " << i << "\n";
+					return false;
+				}
+				savesFound++;
+			}
+
+			std::cout << _kills << " kills while saving, the save slot was whole after each of the " << savesFound << " that had saved\n";
+			return savesFound > 0;
+		}
+
+		bool IsSaveSlotWhole(const std::string& _filePath)
+		{
+			std::ifstream file(_filePath, std::ios::binary);
+			std::vector<UCHAR> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+			UINT32 count = 0;
+			if (data.size() < sizeof(UINT32))
+				return false;
+			std::memcpy(&count, data.data(), sizeof(UINT32));
+			if (data.size() != sizeof(UINT32) + count * sizeof(USHORT))
+				return false;
+
+			for (UINT32 j = 0; j < count; j++)
+			{
+				USHORT value;
+				std::memcpy(&value, &data[sizeof(UINT32) + j * sizeof(USHORT)], sizeof(USHORT));
+				if (value != (USHORT)count)
+					return false;
+			}
+
+			return true;
+		}
+
+		// Times starting up with _sceneCount scenes, cold from the scene files and warm from the archive the cold start packs them into
+		bool BenchmarkSceneLoads(unsigned _sceneCount)
+		{
+			std::filesystem::remove_all(folderPath);
+			std::filesystem::create_directories(folderPath);
+
+			{
+				SaveLoader writer;
+				writer.Init(gameConfig);
+
+				std::mt19937 random(_sceneCount);
+				for (unsigned i = 0; i < _sceneCount; i++)
+				{
+					// Laid out in rows of 32 default sized scenes
+					USHORT sceneIndex = writer.AddNewScene(std::make_shared<Tilemap>((i % 32) * 39, (i / 32) * 25, 25, 39));
+					FillScene(*writer.GetScene(sceneIndex), random);
+					writer.SaveScene(sceneIndex);
+				}
+				writer.Shutdown();
+			}
+
+			auto coldStart = std::chrono::steady_clock::now();
+			SaveLoader cold;
+			cold.Init(gameConfig);
+			double coldMilliseconds = GetMillisecondsSince(coldStart);
+			cold.Shutdown();
+
+			auto warmStart = std::chrono::steady_clock::now();
+			SaveLoader warm;
+			warm.Init(gameConfig);
+			double warmMilliseconds = GetMillisecondsSince(warmStart);
+
+			auto decodeStart = std::chrono::steady_clock::now();
+			for (USHORT i = 0; i < warm.GetAllScenes().size(); i++)
+				warm.GetScene(i);
+			double decodeMilliseconds = GetMillisecondsSince(decodeStart);
+			warm.Shutdown();
+
+			std::cout << _sceneCount << " scenes: cold start from the scene files " << coldMilliseconds << " ms, warm start from the archive "
+				<< warmMilliseconds << " ms, " << decodeMilliseconds << " ms more to decode every scene\n";
+
+			if (!AreScenesEqual(cold, warm))
+			{
+				std::cout << "Scenes mapped from the archive don't match the scene files they were packed from\n";
+				return false;
+			}
+
+			return true;
+		}
+
+		// Encodes random scenes with every combination of codec flags, whole and a chunk at a time, and decodes them back.
+		// Damaged chunk records must either decode or leave the chunk as it was, damaged scenes must not crash decoding.
+		bool TestSceneCodecRoundTrips(unsigned _sceneCount)
+		{
+			std::mt19937 random(_sceneCount);
+			std::vector<UCHAR> data;
+
+			for (unsigned i = 0; i < _sceneCount; i++)
+			{
+				Tilemap scene((INT32)(random() % 2001) - 1000, (INT32)(random() % 2001) - 1000, 1 + random() % 70, 1 + random() % 70);
+				FillRandomScene(scene, random);
+				for (UINT32 neighbors = random() % 4; neighbors > 0; neighbors--)
+					scene.neighborScenes.push_back((USHORT)random());
+
+				for (UINT32 flags = 0; flags <= (SCENE_CODEC_ROW_REPEATS | SCENE_CODEC_BACK_REFERENCES); flags++)
+				{
+					std::shared_ptr<Tilemap> decoded;
+					SceneCodec::Encode(scene, flags, data);
+					if (!SceneCodec::Decode(data.data(), data.size(), decoded) ||
+						!AreTilemapsEqual(scene, *decoded) || scene.neighborScenes != decoded->neighborScenes)
+					{
+						std::cout << "Scene " << i << " didn't survive encoding with codec flags " << flags << "\n";
+						return false;
+					}
+
+					Tilemap chunked(scene.originX, scene.originY, scene.rows, scene.columns);
+					for (UINT32 chunkIndex = 0; chunkIndex < scene.chunks.size(); chunkIndex++)
+					{
+						SceneCodec::EncodeChunk(scene, chunkIndex, flags, data);
+						if (!SceneCodec::DecodeChunk(data.data(), data.size(), chunked))
+						{
+							std::cout << "Chunk " << chunkIndex << " of scene " << i << " didn't decode with codec flags " << flags << "\n";
+							return false;
+						}
+					}
+					if (!AreTilemapsEqual(scene, chunked))
+					{
+						std::cout << "Scene " << i << " didn't survive encoding a chunk at a time with codec flags " << flags << "\n";
+						return false;
+					}
+				}
+
+				// Damaged chunk records
+				Tilemap damaged = scene;
+				UINT32 chunkIndex = random() % scene.chunks.size();
+				SceneCodec::EncodeChunk(scene, chunkIndex, random() % 4, data);
+				data[random() % data.size()] ^= (UCHAR)(1 + random() % 255);
+				if (random() % 2)
+					data.resize(random() % data.size());
+				if (!SceneCodec::DecodeChunk(data.data(), data.size(), damaged) && !AreTilemapsEqual(scene, damaged))
+				{
+					std::cout << "A damaged record for chunk " << chunkIndex << " of scene " << i << " was partly applied\n";
+					return false;
+				}
+
+				// Damaged scenes, checksummed again so the ops get decoded
+				SceneCodec::Encode(scene, random() % 4, data);
+				if (data.size() > sizeof(SceneCodecHeader))
+				{
+					data[sizeof(SceneCodecHeader) + random() % (data.size() - sizeof(SceneCodecHeader))] ^= (UCHAR)(1 + random() % 255);
+					UINT32 checksum = SceneArchive::Checksum(data.data() + sizeof(SceneCodecHeader), data.size() - sizeof(SceneCodecHeader));
+					std::memcpy(data.data() + offsetof(SceneCodecHeader, checksum), &checksum, sizeof(UINT32));
+
+					std::shared_ptr<Tilemap> decoded;
+					SceneCodec::Decode(data.data(), data.size(), decoded);
+				}
+			}
+
+			std::cout << _sceneCount << " random scenes survived encoding and decoding\n";
+			return true;
+		}
+
+		// Times decoding _sceneCount generated scenes from their payloads, the way they're decoded from the archive
+		bool BenchmarkSceneDecodes(unsigned _sceneCount)
+		{
+			std::mt19937 random(_sceneCount);
+			std::vector<std::vector<UCHAR>> payloads(_sceneCount);
+			size_t payloadBytes = 0;
+
+			for (unsigned i = 0; i < _sceneCount; i++)
+			{
+				Tilemap scene(0, 0, 25, 39);
+				FillScene(scene, random);
+				SceneCodec::Encode(scene, SCENE_CODEC_ROW_REPEATS | SCENE_CODEC_BACK_REFERENCES, payloads[i]);
+				payloadBytes += payloads[i].size();
+			}
+
+			auto decodeStart = std::chrono::steady_clock::now();
+			for (const std::vector<UCHAR>& payload : payloads)
+			{
+				std::shared_ptr<Tilemap> decoded;
+				if (!SceneCodec::Decode(payload.data(), payload.size(), decoded))
+				{
+					std::cout << "A generated scene didn't decode\n";
+					return false;
+				}
+			}
+			double decodeMilliseconds = GetMillisecondsSince(decodeStart);
+
+			std::cout << "Decoded " << _sceneCount << " scenes (" << payloadBytes / 1024.0 << " KB) in " << decodeMilliseconds << " ms, "
+				<< decodeMilliseconds * 1000 / max(_sceneCount, 1u) << " us per scene\n";
+			return true;
+		}
+
+		// Rows that repeat the one above, runs, repeating patterns and noise, so every codec op gets used
+		void FillRandomScene(Tilemap& _scene, std::mt19937& _random)
+		{
+			for (UINT32 row = 0; row < _scene.rows; row++)
+			{
+				UINT32 pattern = _random() % 5;
+				UINT32 period = 2 + _random() % 6;
+
+				for (UINT32 col = 0; col < _scene.columns; col++)
+				{
+					TilemapTile tile(0, 0);
+					if (pattern == 0 && row > 0)
+						tile = _scene.GetTileAt(row - 1, col);
+					else if (pattern == 1)
+						tile = TilemapTile((USHORT)(col / period % 3), 0);
+					else if (pattern == 2 && col >= period)
+						tile = _scene.GetTileAt(row, col - period);
+					else if (pattern == 3)
+						tile = TilemapTile((USHORT)(_random() % 14), (USHORT)(_random() % 300));
+
+					_scene.SetTile(row, col, tile);
+				}
+			}
+		}
+
+		// A floor, walls and some ledges, roughly what the level's scenes hold
+		void FillScene(Tilemap& _scene, std::mt19937& _random)
+		{
+			for (UINT32 col = 0; col < _scene.columns; col++)
+			{
+				_scene.SetTile(0, col, TilemapTile(1, 0));
+				_scene.SetTile(1, col, TilemapTile(1, 1));
+			}
+
+			for (UINT32 row = 2; row < _scene.rows; row++)
+			{
+				_scene.SetTile(row, 0, TilemapTile(2, 2));
+				_scene.SetTile(row, _scene.columns - 1, TilemapTile(2, 3));
+			}
+
+			for (int ledge = 0; ledge < 6; ledge++)
+			{
+				UINT32 row = 3 + _random() % (_scene.rows - 4);
+				UINT32 col = 1 + _random() % (_scene.columns - 2);
+				USHORT tilesetId = (USHORT)(1 + _random() % 4);
+
+				for (UINT32 length = 3 + _random() % 8; length > 0 && col < _scene.columns - 1; length--, col++)
+					_scene.SetTile(row, col, TilemapTile(tilesetId, (USHORT)(_random() % 4)));
+			}
+		}
+
+		bool AreScenesEqual(SaveLoader& _a, SaveLoader& _b)
+		{
+			if (_a.GetAllScenes().size() != _b.GetAllScenes().size())
+				return false;
+
+			for (USHORT i = 0; i < _a.GetAllScenes().size(); i++)
+			{
+				std::shared_ptr<Tilemap> a = _a.GetScene(i);
+				std::shared_ptr<Tilemap> b = _b.GetScene(i);
+				if (!AreTilemapsEqual(*a, *b) || a->neighborScenes != b->neighborScenes)
+					return false;
+			}
+
+			return true;
+		}
+
+		bool AreTilemapsEqual(const Tilemap& _a, const Tilemap& _b)
+		{
+			if (_a.originX != _b.originX || _a.originY != _b.originY || _a.rows != _b.rows || _a.columns != _b.columns)
+				return false;
+
+			for (UINT32 row = 0; row < _a.rows; row++)
+			{
+				for (UINT32 col = 0; col < _a.columns; col++)
+				{
+					if (!(_a.GetTileAt(row, col) == _b.GetTileAt(row, col)))
+						return false;
+				}
+			}
+
+			return true;
+		}
+
+		double GetMillisecondsSince(std::chrono::steady_clock::time_point _start)
+		{
+			return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _start).count();
+		}
+	};
+};
+
+#endif
@@ -0,0 +1,164 @@
+// Writes the save slot on a worker thread so deaths and scene changes don't wait on the disk
+#ifndef SAVESLOTWRITER_H
+#define SAVESLOTWRITER_H
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <iostream>
+
+namespace MAD
+{
+	// Only the newest submitted save is kept, saves submitted while another is being written replace each other.
+	// Each write goes to a temp file that's renamed over the save, so a crash leaves either the old save or the new one.
+	class SaveSlotWriter
+	{
+		std::thread worker;
+		std::mutex mutex;
+		std::condition_variable saveReady;
+
+		std::string filePath;
+		std::string tempFilePath;
+		std::vector<UCHAR> pendingData;
+		// Kept after it's written so it can be written again synced when stopping
+		std::vector<UCHAR> writingData;
+		bool hasPendingData = false;
+		// Whether the last write was flushed to the disk
+		bool isSynced = true;
+		bool isStopping = false;
+
+		std::chrono::milliseconds syncInterval{ 0 };
+		// How long a save that couldn't be written waits before it's tried again
+		static constexpr std::chrono::milliseconds RETRY_DELAY{ 500 };
+		std::chrono::steady_clock::time_point lastSyncTime;
+
+	public:
+		~SaveSlotWriter()
+		{
+			Stop();
+		}
+
+		// Writes are flushed to the disk at most once per _syncInterval milliseconds, 0 flushes every write
+		void Start(const std::string& _filePath, UINT32 _syncInterval)
+		{
+			Stop();
+
+			filePath = _filePath;
+			tempFilePath = _filePath + ".tmp";
+			syncInterval = std::chrono::milliseconds(_syncInterval);
+			lastSyncTime = std::chrono::steady_clock::now();
+			isSynced = true;
+			isStopping = false;
+			worker = std::thread(&SaveSlotWriter::WorkerLoop, this);
+		}
+
+		// Writes whatever is still pending and flushes it to the disk before returning
+		void Stop()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				isStopping = true;
+			}
+			saveReady.notify_all();
+
+			if (worker.joinable())
+				worker.join();
+		}
+
+		bool IsRunning() const
+		{
+			return worker.joinable();
+		}
+
+		// Takes _data's buffer and hands back the one it replaces, so repeated saves don't allocate
+		void Submit(std::vector<UCHAR>& _data)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				pendingData.swap(_data);
+				hasPendingData = true;
+			}
+			saveReady.notify_one();
+		}
+
+	private:
+		void WorkerLoop()
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+
+			while (true)
+			{
+				saveReady.wait(lock, [this] { return hasPendingData || isStopping; });
+
+				if (!hasPendingData)
+					break;
+
+				writingData.swap(pendingData);
+				hasPendingData = false;
+
+				std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+				bool isSyncDue = isStopping || now - lastSyncTime >= syncInterval;
+
+				lock.unlock();
+				bool isWritten = WriteAtomically(writingData, isSyncDue);
+				lock.lock();
+
+				if (isWritten)
+				{
+					isSynced = isSyncDue;
+					if (isSyncDue)
+						lastSyncTime = now;
+				}
+				else if (!isStopping)
+				{
+					// Tried again after a moment unless a newer save replaces it, the save on disk stays the one before
+					saveReady.wait_for(lock, RETRY_DELAY, [this] { return hasPendingData || isStopping; });
+					if (!hasPendingData)
+					{
+						pendingData = writingData;
+						hasPendingData = true;
+					}
+				}
+				else
+				{
+					isSynced = false;
+				}
+			}
+
+			// The last save may have only been written through the file cache, or not at all
+			if (!isSynced)
+			{
+				isSynced = WriteAtomically(writingData, true);
+			}
+		}
+
+		bool WriteAtomically(const std::vector<UCHAR>& _data, bool _sync)
+		{
+			HANDLE file = CreateFileA(tempFilePath.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+			if (file == INVALID_HANDLE_VALUE)
+			{
+				std::cout << "Couldn't open " << tempFilePath << " to save to\n";
+				return false;
+			}
+
+			DWORD bytesWritten = 0;
+			bool isWritten = ::WriteFile(file, _data.data(), (DWORD)_data.size(), &bytesWritten, NULL) && bytesWritten == _data.size();
+			if (isWritten && _sync)
+				isWritten = FlushFileBuffers(file);
+			CloseHandle(file);
+
+			if (isWritten)
+				isWritten = MoveFileExA(tempFilePath.c_str(), filePath.c_str(), MOVEFILE_REPLACE_EXISTING | (_sync ? MOVEFILE_WRITE_THROUGH : 0));
+
+			if (!isWritten)
+				std::cout << "Couldn't save " << filePath << ", the save before it is kept\n";
+
+			return isWritten;
+		}
+	};
+};
+
+#endif
@@ -0,0 +1,193 @@
+// Every scene packed into one file that's mapped instead of read, so scenes are only decoded once they're needed
+#ifndef SCENEARCHIVE_H
+#define SCENEARCHIVE_H
+
+#include <vector>
+#include <cstring>
+
+#include "../Utils/MappedFile.h"
+
+namespace MAD
+{
+	struct SceneArchiveHeader
+	{
+		char magic[4];
+		UINT32 version;
+		UINT32 sceneCount;
+		// Of the table of contents, each payload has its own
+		UINT32 tocChecksum;
+		// Of the names, sizes and write times of the scene files the archive was packed alongside, it's stale once they change
+		UINT32 sourceFingerprint;
+		// Keeps the entries that follow 8 byte aligned
+		UINT32 padding;
+	};
+
+	// Table of contents entry, the bounds let scenes be placed before they're decoded
+	struct SceneArchiveEntry
+	{
+		UINT64 offset;
+		UINT32 size;
+		UINT32 checksum;
+		INT32 originX;
+		INT32 originY;
+		UINT32 rows;
+		UINT32 columns;
+	};
+
+	// Layout: header, sceneCount entries, then each scene's payload in the per scene file format.
+	// Payloads are checked when they're first read rather than on open, so opening only touches the header and entries.
+	class SceneArchive
+	{
+		MappedFile file;
+		const SceneArchiveHeader* header = nullptr;
+		const SceneArchiveEntry* entries = nullptr;
+
+	public:
+		static constexpr char MAGIC[4] = { 'M', 'A', 'D', 'S' };
+		static constexpr UINT32 VERSION = 2;
+
+		bool Open(const std::string& _fileName)
+		{
+			Close();
+
+			if (!file.Open(_fileName) || file.GetSize() < sizeof(SceneArchiveHeader))
+			{
+				Close();
+				return false;
+			}
+
+			const SceneArchiveHeader* fileHeader = (const SceneArchiveHeader*)file.GetData();
+			size_t tocSize = (size_t)fileHeader->sceneCount * sizeof(SceneArchiveEntry);
+
+			if (std::memcmp(fileHeader->magic, MAGIC, sizeof(MAGIC)) != 0 ||
+				fileHeader->version != VERSION ||
+				file.GetSize() - sizeof(SceneArchiveHeader) < tocSize)
+			{
+				Close();
+				return false;
+			}
+
+			const SceneArchiveEntry* fileEntries = (const SceneArchiveEntry*)(file.GetData() + sizeof(SceneArchiveHeader));
+			if (Checksum(fileEntries, tocSize) != fileHeader->tocChecksum)
+			{
+				Close();
+				return false;
+			}
+
+			for (UINT32 i = 0; i < fileHeader->sceneCount; i++)
+			{
+				if (fileEntries[i].offset > file.GetSize() || file.GetSize() - fileEntries[i].offset < fileEntries[i].size)
+				{
+					Close();
+					return false;
+				}
+			}
+
+			header = fileHeader;
+			entries = fileEntries;
+			return true;
+		}
+
+		void Close()
+		{
+			file.Close();
+			header = nullptr;
+			entries = nullptr;
+		}
+
+		bool IsOpen() const
+		{
+			return header != nullptr;
+		}
+
+		UINT32 GetSceneCount() const
+		{
+			return header != nullptr ? header->sceneCount : 0;
+		}
+
+		UINT32 GetTocChecksum() const
+		{
+			return header != nullptr ? header->tocChecksum : 0;
+		}
+
+		UINT32 GetSourceFingerprint() const
+		{
+			return header != nullptr ? header->sourceFingerprint : 0;
+		}
+
+		const SceneArchiveEntry& GetEntry(UINT32 _sceneIndex) const
+		{
+			return entries[_sceneIndex];
+		}
+
+		// Points into the mapping, null if the payload doesn't match its checksum
+		const UCHAR* GetPayload(UINT32 _sceneIndex, size_t& _outSize) const
+		{
+			const SceneArchiveEntry& entry = entries[_sceneIndex];
+			const UCHAR* payload = file.GetData() + entry.offset;
+
+			if (Checksum(payload, entry.size) != entry.checksum)
+				return nullptr;
+
+			_outSize = entry.size;
+			return payload;
+		}
+
+		// Points into the mapping without checking it, for payloads copied out and checked elsewhere
+		const UCHAR* GetUncheckedPayload(UINT32 _sceneIndex) const
+		{
+			return file.GetData() + entries[_sceneIndex].offset;
+		}
+
+		// Fills in the entries' offsets, sizes and checksums, their bounds are left as given
+		static void Pack(std::vector<SceneArchiveEntry>& _entries, const std::vector<std::vector<UCHAR>>& _payloads, UINT32 _sourceFingerprint, std::vector<UCHAR>& _outArchive)
+		{
+			size_t tocSize = _entries.size() * sizeof(SceneArchiveEntry);
+			UINT64 offset = sizeof(SceneArchiveHeader) + tocSize;
+
+			for (size_t i = 0; i < _entries.size(); i++)
+			{
+				_entries[i].offset = offset;
+				_entries[i].size = (UINT32)_payloads[i].size();
+				_entries[i].checksum = Checksum(_payloads[i].data(), _payloads[i].size());
+				offset += _payloads[i].size();
+			}
+
+			SceneArchiveHeader archiveHeader;
+			std::memcpy(archiveHeader.magic, MAGIC, sizeof(MAGIC));
+			archiveHeader.version = VERSION;
+			archiveHeader.sceneCount = (UINT32)_entries.size();
+			archiveHeader.tocChecksum = Checksum(_entries.data(), tocSize);
+			archiveHeader.sourceFingerprint = _sourceFingerprint;
+			archiveHeader.padding = 0;
+
+			_outArchive.resize((size_t)offset);
+			std::memcpy(_outArchive.data(), &archiveHeader, sizeof(SceneArchiveHeader));
+			if (tocSize > 0)
+				std::memcpy(_outArchive.data() + sizeof(SceneArchiveHeader), _entries.data(), tocSize);
+
+			for (size_t i = 0; i < _entries.size(); i++)
+			{
+				if (!_payloads[i].empty())
+					std::memcpy(_outArchive.data() + _entries[i].offset, _payloads[i].data(), _payloads[i].size());
+			}
+		}
+
+		// 32 bit FNV-1a
+		static UINT32 Checksum(const void* _data, size_t _size)
+		{
+			const UCHAR* bytes = (const UCHAR*)_data;
+			UINT32 hash = 2166136261u;
+
+			for (size_t i = 0; i < _size; i++)
+			{
+				hash ^= bytes[i];
+				hash *= 16777619u;
+			}
+
+			return hash;
+		}
+	};
+};
+
+#endif
@@ -0,0 +1,502 @@
+// Versioned encoding of a whole scene, used for the Scene*.txt files and the archive's payloads
+#ifndef SCENECODEC_H
+#define SCENECODEC_H
+
+#include <vector>
+#include <cstring>
+#include <climits>
+#include <algorithm>
+#include <unordered_map>
+
+#include "../Components/Tilemaps.h"
+#include "SceneArchive.h"
+
+namespace MAD
+{
+	struct SceneCodecHeader
+	{
+		char magic[4];
+		UINT32 version;
+		// Of everything after the header
+		UINT32 checksum;
+	};
+
+	// Low two bits of every op's first varint, the rest of it is the op's length
+	enum SceneCodecOp : UINT32
+	{
+		// length copies of the tile whose tilesetId and orientationId varints follow
+		SCENE_OP_RUN,
+		// length rows that each repeat the row above, only at the start of a row
+		SCENE_OP_ROW_REPEAT,
+		// length tiles copied one at a time from the distance varint that follows tiles back, so they may overlap
+		SCENE_OP_BACK_REFERENCE,
+		// length tiles that each have their tilesetId and orientationId varints following, for stretches no other op fits
+		SCENE_OP_LITERALS
+	};
+
+	// Which of the optional ops the encoder looks for, decoding always understands every op
+	enum SceneCodecFlags : UINT32
+	{
+		SCENE_CODEC_ROW_REPEATS = 1,
+		SCENE_CODEC_BACK_REFERENCES = 2
+	};
+
+	// Layout: header, then varints for the origin (zigzagged), rows, columns, neighbour count and neighbour indices,
+	// then ops filling the tiles row by row. Files from before the header are raw Tilemap members followed by
+	// CompressedTile runs, IsEncoded tells them apart.
+	class SceneCodec
+	{
+		// Shortest back reference worth its distance varint, also how many tiles the match finder hashes
+		static constexpr UINT32 MIN_BACK_REFERENCE = 3;
+		// Candidates tried per tile when looking for a back reference
+		static constexpr UINT32 MAX_MATCH_CANDIDATES = 16;
+		// So that any op's length fits above its two op bits
+		static constexpr UINT64 MAX_TILES = UINT_MAX >> 2;
+
+	public:
+		static constexpr char MAGIC[4] = { 'M', 'A', 'D', 'T' };
+		static constexpr UINT32 VERSION = 2;
+
+		static bool IsEncoded(const UCHAR* _data, size_t _dataSize)
+		{
+			return _dataSize >= sizeof(SceneCodecHeader) && std::memcmp(_data, MAGIC, sizeof(MAGIC)) == 0;
+		}
+
+		// _tilemap must have no more than MAX_TILES tiles
+		static void Encode(const Tilemap& _tilemap, UINT32 _flags, std::vector<UCHAR>& _outData)
+		{
+			_outData.assign(sizeof(SceneCodecHeader), 0);
+
+			PushVarint(_outData, Zigzag(_tilemap.originX));
+			PushVarint(_outData, Zigzag(_tilemap.originY));
+			PushVarint(_outData, _tilemap.rows);
+			PushVarint(_outData, _tilemap.columns);
+			PushVarint(_outData, (UINT32)_tilemap.neighborScenes.size());
+			for (USHORT neighbor : _tilemap.neighborScenes)
+				PushVarint(_outData, neighbor);
+
+			// Matching is simpler over the tiles laid out in file order than through the chunks
+			std::vector<TilemapTile> cells;
+			cells.reserve((size_t)_tilemap.rows * _tilemap.columns);
+			for (UINT32 row = 0; row < _tilemap.rows; row++)
+			{
+				_tilemap.ForEachRowSpan(row, [&cells](UINT32 _col, UINT32 _count, const TilemapTile* _tiles, UINT32 _stride)
+					{
+						for (UINT32 i = 0; i < _count; i++)
+							cells.push_back(_tiles[i * _stride]);
+					});
+			}
+
+			EncodeTiles(cells, _tilemap.columns, _flags, _outData);
+
+			SceneCodecHeader header;
+			std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+			header.version = VERSION;
+			header.checksum = SceneArchive::Checksum(_outData.data() + sizeof(SceneCodecHeader), _outData.size() - sizeof(SceneCodecHeader));
+			std::memcpy(_outData.data(), &header, sizeof(SceneCodecHeader));
+		}
+
+		// Spawnpoints and collision bitmaps are left to the caller
+		static bool Decode(const UCHAR* _data, size_t _dataSize, std::shared_ptr<Tilemap>& _outTilemap)
+		{
+			if (!IsEncoded(_data, _dataSize))
+				return false;
+
+			SceneCodecHeader header;
+			std::memcpy(&header, _data, sizeof(SceneCodecHeader));
+			if (header.version != VERSION ||
+				SceneArchive::Checksum(_data + sizeof(SceneCodecHeader), _dataSize - sizeof(SceneCodecHeader)) != header.checksum)
+				return false;
+
+			const UCHAR* cursor = _data + sizeof(SceneCodecHeader);
+			const UCHAR* end = _data + _dataSize;
+
+			UINT32 originX, originY, rows, columns, neighborCount;
+			if (!ReadVarint(cursor, end, originX) || !ReadVarint(cursor, end, originY) ||
+				!ReadVarint(cursor, end, rows) || !ReadVarint(cursor, end, columns) ||
+				!ReadVarint(cursor, end, neighborCount))
+				return false;
+
+			// Each neighbour index takes at least a byte, so more than the data left can't be real
+			if ((UINT64)rows * columns > MAX_TILES || neighborCount > (size_t)(end - cursor))
+				return false;
+
+			_outTilemap = std::make_shared<Tilemap>(Unzigzag(originX), Unzigzag(originY), rows, columns);
+
+			_outTilemap->neighborScenes.resize(neighborCount);
+			for (UINT32 i = 0; i < neighborCount; i++)
+			{
+				UINT32 neighbor;
+				if (!ReadVarint(cursor, end, neighbor))
+					return false;
+				_outTilemap->neighborScenes[i] = (USHORT)neighbor;
+			}
+
+			if (!DecodeTiles(cursor, end, _outTilemap.get(), 0, 0, rows, columns))
+				return false;
+
+			// Chunks filled a run at a time that ended up all one tile go back to being uniform
+			_outTilemap->CompactChunks();
+			return true;
+		}
+
+		// For scene journal records, which are checksummed on their own: the chunk's index, then ops filling
+		// the chunk's cells inside the tilemap row by row
+		static void EncodeChunk(const Tilemap& _tilemap, UINT32 _chunkIndex, UINT32 _flags, std::vector<UCHAR>& _outData)
+		{
+			_outData.clear();
+			PushVarint(_outData, _chunkIndex);
+
+			UINT32 minRow, minCol, chunkRows, chunkColumns;
+			_tilemap.GetChunkBounds(_chunkIndex, minRow, minCol, chunkRows, chunkColumns);
+
+			std::vector<TilemapTile> cells;
+			cells.reserve((size_t)chunkRows * chunkColumns);
+			for (UINT32 row = minRow; row < minRow + chunkRows; row++)
+			{
+				for (UINT32 col = minCol; col < minCol + chunkColumns; col++)
+					cells.push_back(_tilemap.GetTileAt(row, col));
+			}
+
+			EncodeTiles(cells, chunkColumns, _flags, _outData);
+		}
+
+		static bool DecodeChunk(const UCHAR* _data, size_t _dataSize, Tilemap& _tilemap)
+		{
+			const UCHAR* cursor = _data;
+			const UCHAR* end = _data + _dataSize;
+
+			UINT32 chunkIndex;
+			if (!ReadVarint(cursor, end, chunkIndex) || chunkIndex >= _tilemap.chunks.size())
+				return false;
+
+			UINT32 minRow, minCol, chunkRows, chunkColumns;
+			_tilemap.GetChunkBounds(chunkIndex, minRow, minCol, chunkRows, chunkColumns);
+
+			// The ops are checked before any is applied, so a torn record leaves the chunk as it was
+			const UCHAR* ops = cursor;
+			if (!DecodeTiles(cursor, end, nullptr, minRow, minCol, chunkRows, chunkColumns))
+				return false;
+
+			return DecodeTiles(ops, end, &_tilemap, minRow, minCol, chunkRows, chunkColumns);
+		}
+
+	private:
+		static void EncodeTiles(const std::vector<TilemapTile>& _cells, UINT32 _columns, UINT32 _flags, std::vector<UCHAR>& _outData)
+		{
+			// Latest position of each hashed run of MIN_BACK_REFERENCE tiles, and for each position the one before it with the same hash
+			std::unordered_map<UINT64, UINT32> matchHeads;
+			std::vector<UINT32> matchChain;
+			bool useBackReferences = (_flags & SCENE_CODEC_BACK_REFERENCES) != 0;
+			if (useBackReferences)
+				matchChain.assign(_cells.size(), UINT_MAX);
+
+			UINT32 indexedCells = 0;
+			auto indexCellsUntil = [&](UINT32 _end)
+				{
+					for (; indexedCells < _end && indexedCells + MIN_BACK_REFERENCE <= _cells.size(); indexedCells++)
+					{
+						auto head = matchHeads.try_emplace(HashCells(&_cells[indexedCells]), indexedCells);
+						if (!head.second)
+						{
+							matchChain[indexedCells] = head.first->second;
+							head.first->second = indexedCells;
+						}
+					}
+				};
+
+			UINT32 cellCount = (UINT32)_cells.size();
+			UINT32 cell = 0;
+			// Single tiles from here to cell are written together as one literals op
+			UINT32 literalStart = 0;
+			auto pushLiterals = [&]()
+				{
+					if (literalStart == cell)
+						return;
+
+					PushVarint(_outData, ((cell - literalStart) << 2) | SCENE_OP_LITERALS);
+					for (UINT32 i = literalStart; i < cell; i++)
+					{
+						PushVarint(_outData, _cells[i].tilesetId);
+						PushVarint(_outData, _cells[i].orientationId);
+					}
+				};
+
+			while (cell < cellCount)
+			{
+				if ((_flags & SCENE_CODEC_ROW_REPEATS) && cell % _columns == 0 && cell > 0)
+				{
+					UINT32 repeatedRows = 0;
+					for (UINT32 rowStart = cell; rowStart + _columns <= cellCount; rowStart += _columns)
+					{
+						if (!std::equal(&_cells[rowStart], &_cells[rowStart] + _columns, &_cells[rowStart - _columns]))
+							break;
+						repeatedRows++;
+					}
+
+					if (repeatedRows > 0)
+					{
+						pushLiterals();
+						PushVarint(_outData, (repeatedRows << 2) | SCENE_OP_ROW_REPEAT);
+						cell += repeatedRows * _columns;
+						literalStart = cell;
+						continue;
+					}
+				}
+
+				UINT32 runLength = 1;
+				while (cell + runLength < cellCount && _cells[cell + runLength] == _cells[cell])
+					runLength++;
+
+				if (useBackReferences && runLength < MIN_BACK_REFERENCE && cell + MIN_BACK_REFERENCE <= cellCount)
+				{
+					indexCellsUntil(cell);
+
+					UINT32 bestLength = 0, bestDistance = 0;
+					auto head = matchHeads.find(HashCells(&_cells[cell]));
+					UINT32 candidate = head != matchHeads.end() ? head->second : UINT_MAX;
+
+					for (UINT32 tries = 0; candidate != UINT_MAX && tries < MAX_MATCH_CANDIDATES; tries++, candidate = matchChain[candidate])
+					{
+						UINT32 length = 0;
+						while (cell + length < cellCount && _cells[candidate + length] == _cells[cell + length])
+							length++;
+
+						if (length > bestLength)
+						{
+							bestLength = length;
+							bestDistance = cell - candidate;
+						}
+					}
+
+					if (bestLength >= MIN_BACK_REFERENCE)
+					{
+						pushLiterals();
+						PushVarint(_outData, (bestLength << 2) | SCENE_OP_BACK_REFERENCE);
+						PushVarint(_outData, bestDistance);
+						cell += bestLength;
+						literalStart = cell;
+						continue;
+					}
+				}
+
+				if (runLength == 1)
+				{
+					cell++;
+					continue;
+				}
+
+				pushLiterals();
+				PushVarint(_outData, (runLength << 2) | SCENE_OP_RUN);
+				PushVarint(_outData, _cells[cell].tilesetId);
+				PushVarint(_outData, _cells[cell].orientationId);
+				cell += runLength;
+				literalStart = cell;
+			}
+
+			pushLiterals();
+		}
+
+		// Ops are decoded straight into _tilemap's _rows x _columns cells from _minRow, _minCol in file order, or only checked
+		// if _tilemap is null. Runs are filled a chunk's row at a time, row repeats and back references copy the tiles
+		// already decoded straight into dense chunks and a run of matching ones at a time into uniform ones.
+		static bool DecodeTiles(
+			const UCHAR*& _cursor, 
+			const UCHAR* _end, 
+			Tilemap* _tilemap, 
+			UINT32 _minRow, 
+			UINT32 _minCol, 
+			UINT32 _rows, 
+			UINT32 _columns)
+		{
+			UINT32 cellCount = _rows * _columns;
+			UINT32 cell = 0;
+
+			auto fillCells = [&](UINT32 _cell, UINT32 _count, TilemapTile _tile)
+				{
+					while (_count > 0)
+					{
+						UINT32 col = _cell % _columns;
+						UINT32 spanLength = min(_count, _columns - col);
+						_tilemap->FillRow(_minRow + _cell / _columns, _minCol + col, spanLength, _tile);
+						_cell += spanLength;
+						_count -= spanLength;
+					}
+				};
+
+			// Copied a span at a time that stays in one row and chunk on both ends and doesn't reach past _cell,
+			// so an overlapping copy repeats what it just made like a one at a time copy would
+			auto copyCells = [&](UINT32 _cell, UINT32 _count, UINT32 _distance)
+				{
+					for (UINT32 copyEnd = _cell + _count; _cell < copyEnd;)
+					{
+						UINT32 source = _cell - _distance;
+						UINT32 sourceRow = _minRow + source / _columns;
+						UINT32 sourceCol = _minCol + source % _columns;
+						UINT32 row = _minRow + _cell / _columns;
+						UINT32 col = _minCol + _cell % _columns;
+						UINT32 spanLength = min(min(copyEnd - _cell, _distance), min(_minCol + _columns - col, _minCol + _columns - sourceCol));
+						spanLength = min(spanLength, min(Tilemap::CHUNK_SIZE - sourceCol % Tilemap::CHUNK_SIZE, Tilemap::CHUNK_SIZE - col % Tilemap::CHUNK_SIZE));
+
+						const TileChunk& sourceChunk = _tilemap->chunks[(size_t)(sourceRow / Tilemap::CHUNK_SIZE) * _tilemap->chunkColumns + sourceCol / Tilemap::CHUNK_SIZE];
+						if (!sourceChunk.IsDense())
+						{
+							_tilemap->FillRow(row, col, spanLength, sourceChunk.uniformTile);
+							_cell += spanLength;
+							continue;
+						}
+
+						std::vector<TilemapTile>& denseTiles = _tilemap->denseTiles;
+						size_t sourceOffset = sourceChunk.denseOffset + (sourceRow % Tilemap::CHUNK_SIZE) * Tilemap::CHUNK_SIZE + sourceCol % Tilemap::CHUNK_SIZE;
+						const TileChunk& chunk = _tilemap->chunks[(size_t)(row / Tilemap::CHUNK_SIZE) * _tilemap->chunkColumns + col / Tilemap::CHUNK_SIZE];
+
+						// The span can't reach the tiles it's copied from, it's no longer than _distance
+						if (chunk.IsDense())
+						{
+							std::copy_n(denseTiles.begin() + sourceOffset, spanLength,
+								denseTiles.begin() + chunk.denseOffset + (row % Tilemap::CHUNK_SIZE) * Tilemap::CHUNK_SIZE + col % Tilemap::CHUNK_SIZE);
+							_cell += spanLength;
+							continue;
+						}
+
+						// Read by index, filling may make the chunk dense and move the dense tiles
+						for (UINT32 i = 0; i < spanLength;)
+						{
+							TilemapTile tile = denseTiles[sourceOffset + i];
+							UINT32 runLength = 1;
+							while (i + runLength < spanLength && denseTiles[sourceOffset + i + runLength] == tile)
+								runLength++;
+
+							_tilemap->FillRow(row, col + i, runLength, tile);
+							i += runLength;
+						}
+						_cell += spanLength;
+					}
+				};
+
+			while (cell < cellCount)
+			{
+				UINT32 opCode;
+				if (!ReadVarint(_cursor, _end, opCode))
+					return false;
+
+				UINT32 length = opCode >> 2;
+				if (length == 0 || length > cellCount - cell)
+					return false;
+
+				switch (opCode & 3)
+				{
+				case SCENE_OP_RUN:
+				{
+					UINT32 tilesetId, orientationId;
+					if (!ReadVarint(_cursor, _end, tilesetId) || !ReadVarint(_cursor, _end, orientationId))
+						return false;
+
+					if (_tilemap != nullptr)
+						fillCells(cell, length, TilemapTile((USHORT)tilesetId, (USHORT)orientationId));
+					break;
+				}
+				case SCENE_OP_ROW_REPEAT:
+				{
+					if (cell % _columns != 0 || cell == 0 || length > (cellCount - cell) / _columns)
+						return false;
+
+					length *= _columns;
+					if (_tilemap != nullptr)
+						copyCells(cell, length, _columns);
+					break;
+				}
+				case SCENE_OP_BACK_REFERENCE:
+				{
+					UINT32 distance;
+					if (!ReadVarint(_cursor, _end, distance) || distance == 0 || distance > cell)
+						return false;
+
+					if (_tilemap != nullptr)
+						copyCells(cell, length, distance);
+					break;
+				}
+				case SCENE_OP_LITERALS:
+				{
+					UINT32 row = _minRow + cell / _columns;
+					UINT32 col = cell % _columns;
+					for (UINT32 i = 0; i < length; i++)
+					{
+						UINT32 tilesetId, orientationId;
+						if (!ReadVarint(_cursor, _end, tilesetId) || !ReadVarint(_cursor, _end, orientationId))
+							return false;
+
+						if (_tilemap != nullptr)
+							_tilemap->FillRow(row, _minCol + col, 1, TilemapTile((USHORT)tilesetId, (USHORT)orientationId));
+
+						if (++col == _columns)
+						{
+							row++;
+							col = 0;
+						}
+					}
+					break;
+				}
+				}
+
+				cell += length;
+			}
+
+			return true;
+		}
+
+		static UINT64 HashCells(const TilemapTile* _cells)
+		{
+			UINT64 hash = 0;
+			for (UINT32 i = 0; i < MIN_BACK_REFERENCE; i++)
+				hash = hash * 0x100000001B3ull ^ (((UINT64)_cells[i].tilesetId << 16) | _cells[i].orientationId);
+			return hash;
+		}
+
+		static UINT32 Zigzag(INT32 _value)
+		{
+			return ((UINT32)_value << 1) ^ (UINT32)(_value >> 31);
+		}
+
+		static INT32 Unzigzag(UINT32 _value)
+		{
+			return (INT32)(_value >> 1) ^ -(INT32)(_value & 1);
+		}
+
+		static void PushVarint(std::vector<UCHAR>& _outData, UINT32 _value)
+		{
+			while (_value >= 0x80)
+			{
+				_outData.push_back((UCHAR)(_value | 0x80));
+				_value >>= 7;
+			}
+			_outData.push_back((UCHAR)_value);
+		}
+
+		static bool ReadVarint(const UCHAR*& _cursor, const UCHAR* _end, UINT32& _outValue)
+		{
+			// Most ids and lengths fit in one byte
+			if (_cursor != _end && *_cursor < 0x80)
+			{
+				_outValue = *_cursor++;
+				return true;
+			}
+
+			_outValue = 0;
+			for (UINT32 shift = 0; shift < 35; shift += 7)
+			{
+				if (_cursor == _end)
+					return false;
+
+				UCHAR byte = *_cursor++;
+				_outValue |= (UINT32)(byte & 0x7F) << shift;
+				if (!(byte & 0x80))
+					return true;
+			}
+
+			return false;
+		}
+	};
+};
+
+#endif
@@ -0,0 +1,192 @@
+// Scene edits appended to a file beside the scene archive, so saving an edit doesn't rewrite every scene
+#ifndef SCENEJOURNAL_H
+#define SCENEJOURNAL_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iterator>
+#include <cstring>
+
+#include "SceneArchive.h"
+
+namespace MAD
+{
+	enum SceneJournalRecordType : UCHAR
+	{
+		// Bounds of a scene added after the archive was written, its index is the next one
+		JOURNAL_NEW_SCENE,
+		// The scene's whole neighbour list
+		JOURNAL_NEIGHBORS,
+		// One chunk's tiles as written by SceneCodec::EncodeChunk
+		JOURNAL_CHUNK
+	};
+
+	struct SceneJournalHeader
+	{
+		char magic[4];
+		UINT32 version;
+		// The records only apply to the archive whose table of contents has this checksum
+		UINT32 archiveChecksum;
+	};
+
+	struct SceneJournalRecord
+	{
+		SceneJournalRecordType type;
+		UCHAR padding;
+		USHORT sceneIndex;
+		UINT32 size;
+		// Of the size bytes following the record
+		UINT32 checksum;
+	};
+
+	// Layout: header, then records each followed by their data, in the order they were saved.
+	// A record cut short by a crash fails its checksum, it and everything after it are dropped when the journal is opened.
+	class SceneJournal
+	{
+		std::string filePath;
+		std::ofstream file;
+		std::vector<UCHAR> pendingRecords;
+		size_t fileSize = 0;
+
+	public:
+		static constexpr char MAGIC[4] = { 'M', 'A', 'D', 'J' };
+		static constexpr UINT32 VERSION = 2;
+
+		// Reads the journal's intact records into _outRecords if it belongs to the archive with _archiveChecksum,
+		// otherwise it's started over empty. Either way it's left open for appending.
+		bool Open(const std::string& _filePath, UINT32 _archiveChecksum, std::vector<UCHAR>& _outRecords)
+		{
+			filePath = _filePath;
+			_outRecords.clear();
+
+			std::vector<UCHAR> fileData;
+			{
+				std::ifstream existingFile(filePath, std::ios::binary);
+				if (existingFile)
+					fileData.assign(std::istreambuf_iterator<char>(existingFile), std::istreambuf_iterator<char>());
+			}
+
+			const SceneJournalHeader* header = (const SceneJournalHeader*)fileData.data();
+			if (fileData.size() < sizeof(SceneJournalHeader) ||
+				std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 ||
+				header->version != VERSION ||
+				header->archiveChecksum != _archiveChecksum)
+			{
+				return Reset(_filePath, _archiveChecksum);
+			}
+
+			size_t recordsEnd = sizeof(SceneJournalHeader);
+			while (fileData.size() - recordsEnd >= sizeof(SceneJournalRecord))
+			{
+				// Records follow each other's data, so they're not necessarily aligned
+				SceneJournalRecord record;
+				std::memcpy(&record, &fileData[recordsEnd], sizeof(SceneJournalRecord));
+				const UCHAR* recordData = &fileData[recordsEnd] + sizeof(SceneJournalRecord);
+				size_t dataAvailable = fileData.size() - recordsEnd - sizeof(SceneJournalRecord);
+
+				if (record.size > dataAvailable || SceneArchive::Checksum(recordData, record.size) != record.checksum)
+					break;
+
+				recordsEnd += sizeof(SceneJournalRecord) + record.size;
+			}
+
+			_outRecords.assign(fileData.begin() + sizeof(SceneJournalHeader), fileData.begin() + recordsEnd);
+
+			// Anything after the last intact record is cut off so new records aren't appended behind it
+			if (recordsEnd != fileData.size())
+			{
+				std::ofstream truncatedFile(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+				truncatedFile.write((const char*)fileData.data(), recordsEnd);
+				if (!truncatedFile)
+					return false;
+			}
+
+			file.close();
+			file.open(filePath, std::ios::out | std::ios::binary | std::ios::app);
+			fileSize = recordsEnd;
+			pendingRecords.clear();
+
+			return (bool)file;
+		}
+
+		// Starts the journal at _filePath over empty, for when the archive has been rewritten with every record in it
+		bool Reset(const std::string& _filePath, UINT32 _archiveChecksum)
+		{
+			filePath = _filePath;
+
+			SceneJournalHeader header;
+			std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+			header.version = VERSION;
+			header.archiveChecksum = _archiveChecksum;
+
+			file.close();
+			file.open(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+			file.write((const char*)&header, sizeof(SceneJournalHeader));
+			file.flush();
+
+			fileSize = sizeof(SceneJournalHeader);
+			pendingRecords.clear();
+
+			return (bool)file;
+		}
+
+		bool IsOpen() const
+		{
+			return file.is_open();
+		}
+
+		// Queued until Commit
+		void Append(SceneJournalRecordType _type, USHORT _sceneIndex, const std::vector<UCHAR>& _data)
+		{
+			SceneJournalRecord record = { _type, 0, _sceneIndex, (UINT32)_data.size(), SceneArchive::Checksum(_data.data(), _data.size()) };
+
+			size_t recordStart = pendingRecords.size();
+			pendingRecords.resize(recordStart + sizeof(SceneJournalRecord) + _data.size());
+			std::memcpy(&pendingRecords[recordStart], &record, sizeof(SceneJournalRecord));
+			if (!_data.empty())
+				std::memcpy(&pendingRecords[recordStart + sizeof(SceneJournalRecord)], _data.data(), _data.size());
+		}
+
+		// Writes the records appended since the last Commit in one go
+		bool Commit()
+		{
+			if (pendingRecords.empty())
+				return true;
+
+			file.write((const char*)pendingRecords.data(), pendingRecords.size());
+			file.flush();
+
+			fileSize += pendingRecords.size();
+			pendingRecords.clear();
+
+			return (bool)file;
+		}
+
+		bool HasRecords() const
+		{
+			return fileSize > sizeof(SceneJournalHeader);
+		}
+
+		// Includes the header
+		size_t GetSize() const
+		{
+			return fileSize;
+		}
+
+		// Calls _onRecord(record, data) for each record read by Open
+		template <typename F>
+		static void ForEachRecord(const std::vector<UCHAR>& _records, const F& _onRecord)
+		{
+			for (size_t offset = 0; offset < _records.size();)
+			{
+				SceneJournalRecord record;
+				std::memcpy(&record, &_records[offset], sizeof(SceneJournalRecord));
+				_onRecord(record, &_records[offset] + sizeof(SceneJournalRecord));
+				offset += sizeof(SceneJournalRecord) + record.size;
+			}
+		}
+	};
+};
+
+#endif
@@ -0,0 +1,325 @@
+// Decodes and prepares the tiles of scenes on a worker thread ahead of need, LevelLogic spawns the finished batches
+#ifndef SCENESTREAMER_H
+#define SCENESTREAMER_H
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <functional>
+
+#include "../Components/Tilemaps.h"
+
+namespace MAD
+{
+	// Rectangle of cells in a scene
+	struct TileRect
+	{
+		USHORT row;
+		USHORT col;
+		USHORT width;
+		USHORT height;
+	};
+
+	struct TileSpawn
+	{
+		TilemapTile tile;
+		USHORT row;
+		USHORT col;
+	};
+
+	// What a scene is prepared from. Scenes the archive is current for hand over a copy of their encoded payload,
+	// which is small, so decoding happens on the worker too. Scenes edited since it was packed hand over a snapshot.
+	struct SceneSource
+	{
+		std::shared_ptr<const std::vector<UCHAR>> payload;
+		UINT32 payloadChecksum = 0;
+		std::shared_ptr<const Tilemap> scene;
+	};
+
+	// Everything needed to spawn one scene, built from its SceneSource.
+	// The committed counts let a batch be spawned over several frames.
+	struct SceneSpawnBatch
+	{
+		USHORT sceneIndex;
+		float priority;
+		// Decoded on the worker from the source's payload, for SaveLoader to keep once the batch is committed
+		std::shared_ptr<Tilemap> scene;
+		std::vector<TileSpawn> tiles;
+		// Solid tiles sharing one compound collider, only filled when tile colliders are merged
+		std::vector<TileRect> solidRects;
+		size_t committedTiles = 0;
+		size_t committedRects = 0;
+		// Time spent committing so far, for logStats
+		double spawnMilliseconds = 0;
+		// Tiles taken back from LevelLogic's pool instead of created, for logStats
+		size_t reusedTiles = 0;
+	};
+
+	class SceneStreamer
+	{
+	public:
+		// Turns a payload into its scene with spawnpoints and collision bitmaps, called from the worker so it must be thread safe.
+		// Null if the payload is corrupt.
+		typedef std::function<std::shared_ptr<Tilemap>(const SceneSource& _source)> SceneDecoder;
+
+	private:
+		struct SceneRequest
+		{
+			USHORT sceneIndex;
+			float priority;
+			SceneSource source;
+		};
+
+		std::thread worker;
+		std::mutex mutex;
+		std::condition_variable requestReady;
+		std::condition_variable batchReady;
+
+		std::vector<SceneRequest> requests;
+		std::vector<std::shared_ptr<SceneSpawnBatch>> readyBatches;
+		int preparingScene = -1;
+		// Bumped by Clear so a batch that was being prepared is thrown away
+		UINT64 clearGeneration = 0;
+		bool mergeSolidTiles = false;
+		SceneDecoder decodeScene;
+		bool isStopping = false;
+
+	public:
+		~SceneStreamer()
+		{
+			Stop();
+		}
+
+		void Start(bool _mergeSolidTiles, SceneDecoder _decodeScene)
+		{
+			Stop();
+
+			mergeSolidTiles = _mergeSolidTiles;
+			decodeScene = std::move(_decodeScene);
+			isStopping = false;
+			worker = std::thread(&SceneStreamer::WorkerLoop, this);
+		}
+
+		void Stop()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				isStopping = true;
+			}
+			requestReady.notify_all();
+
+			if (worker.joinable())
+				worker.join();
+
+			requests.clear();
+			readyBatches.clear();
+		}
+
+		// Queues the scene to be decoded and prepared, lower priorities are prepared and committed first
+		void Request(USHORT _sceneIndex, SceneSource _source, float _priority)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				requests.push_back({ _sceneIndex, _priority, std::move(_source) });
+			}
+			requestReady.notify_one();
+		}
+
+		void SetPriority(USHORT _sceneIndex, float _priority)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			for (SceneRequest& request : requests)
+			{
+				if (request.sceneIndex == _sceneIndex)
+					request.priority = _priority;
+			}
+			for (auto& batch : readyBatches)
+			{
+				if (batch->sceneIndex == _sceneIndex)
+					batch->priority = _priority;
+			}
+		}
+
+		// True from Request until the scene's batch is taken
+		bool IsStreaming(USHORT _sceneIndex)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			return preparingScene == _sceneIndex || FindRequest(_sceneIndex) != requests.end() || FindReady(_sceneIndex) != readyBatches.end();
+		}
+
+		// Hands over the most urgent finished batch, or null if none are done
+		std::shared_ptr<SceneSpawnBatch> PopReady()
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (readyBatches.empty())
+				return nullptr;
+
+			auto batch = std::min_element(readyBatches.begin(), readyBatches.end(),
+				[](const auto& _a, const auto& _b) { return _a->priority < _b->priority; });
+
+			std::shared_ptr<SceneSpawnBatch> readyBatch = std::move(*batch);
+			readyBatches.erase(batch);
+			return readyBatch;
+		}
+
+		// Hands over _sceneIndex's batch now, waiting on the worker if it's preparing it and preparing it
+		// on this thread if the worker hasn't started it. Null if the scene was never requested.
+		std::shared_ptr<SceneSpawnBatch> Take(USHORT _sceneIndex)
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			batchReady.wait(lock, [this, _sceneIndex] { return preparingScene != _sceneIndex; });
+
+			auto ready = FindReady(_sceneIndex);
+			if (ready != readyBatches.end())
+			{
+				std::shared_ptr<SceneSpawnBatch> batch = std::move(*ready);
+				readyBatches.erase(ready);
+				return batch;
+			}
+
+			auto request = FindRequest(_sceneIndex);
+			if (request == requests.end())
+				return nullptr;
+
+			SceneRequest takenRequest = std::move(*request);
+			requests.erase(request);
+			lock.unlock();
+
+			return PrepareRequest(takenRequest);
+		}
+
+		// Forgets every request and unclaimed batch
+		void Clear()
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			requests.clear();
+			readyBatches.clear();
+			clearGeneration++;
+		}
+
+		static void Prepare(USHORT _sceneIndex, const Tilemap& _scene, bool _mergeSolidTiles, SceneSpawnBatch& _outBatch)
+		{
+			_outBatch.sceneIndex = _sceneIndex;
+			_outBatch.tiles.clear();
+			_outBatch.solidRects.clear();
+
+			_scene.ForEachTile([&_outBatch](UINT32 _row, UINT32 _col, const TilemapTile& _tile)
+				{
+					_outBatch.tiles.push_back({ _tile, (USHORT)_row, (USHORT)_col });
+				});
+
+			if (_mergeSolidTiles)
+				MergeSolidTiles(_scene.solidTiles, _outBatch.solidRects);
+		}
+
+		// Greedily grows rectangles of solid tiles, first along the row then up the columns
+		static void MergeSolidTiles(const TileBitmap& _solidTiles, std::vector<TileRect>& _outRects)
+		{
+			TileBitmap isMerged;
+			isMerged.Resize(_solidTiles.rows, _solidTiles.columns);
+
+			auto isMergeable = [&](UINT32 _row, UINT32 _col)
+				{
+					return _solidTiles.Get(_row, _col) && !isMerged.Get(_row, _col);
+				};
+
+			for (UINT32 row = 0; row < _solidTiles.rows; row++)
+			{
+				for (UINT32 col = 0; col < _solidTiles.columns; col++)
+				{
+					if (!isMergeable(row, col))
+						continue;
+
+					UINT32 width = 1;
+					while (col + width < _solidTiles.columns && isMergeable(row, col + width))
+						width++;
+
+					UINT32 height = 1;
+					while (row + height < _solidTiles.rows)
+					{
+						bool isRowMergeable = true;
+						for (UINT32 rowCol = col; rowCol < col + width && isRowMergeable; rowCol++)
+							isRowMergeable = isMergeable(row + height, rowCol);
+
+						if (!isRowMergeable)
+							break;
+						height++;
+					}
+
+					for (UINT32 mergedRow = row; mergedRow < row + height; mergedRow++)
+						for (UINT32 mergedCol = col; mergedCol < col + width; mergedCol++)
+							isMerged.Set(mergedRow, mergedCol, true);
+
+					_outRects.push_back({ (USHORT)row, (USHORT)col, (USHORT)width, (USHORT)height });
+				}
+			}
+		}
+
+	private:
+		// Decodes the request's payload if it has one, a corrupt payload leaves the batch empty
+		std::shared_ptr<SceneSpawnBatch> PrepareRequest(const SceneRequest& _request)
+		{
+			std::shared_ptr<SceneSpawnBatch> batch = std::make_shared<SceneSpawnBatch>();
+			batch->sceneIndex = _request.sceneIndex;
+			batch->priority = _request.priority;
+
+			std::shared_ptr<const Tilemap> scene = _request.source.scene;
+			if (_request.source.payload != nullptr)
+			{
+				batch->scene = decodeScene(_request.source);
+				scene = batch->scene;
+			}
+
+			if (scene != nullptr)
+				Prepare(_request.sceneIndex, *scene, mergeSolidTiles, *batch);
+
+			return batch;
+		}
+
+		std::vector<SceneRequest>::iterator FindRequest(USHORT _sceneIndex)
+		{
+			return std::find_if(requests.begin(), requests.end(),
+				[_sceneIndex](const SceneRequest& _request) { return _request.sceneIndex == _sceneIndex; });
+		}
+
+		std::vector<std::shared_ptr<SceneSpawnBatch>>::iterator FindReady(USHORT _sceneIndex)
+		{
+			return std::find_if(readyBatches.begin(), readyBatches.end(),
+				[_sceneIndex](const auto& _batch) { return _batch->sceneIndex == _sceneIndex; });
+		}
+
+		void WorkerLoop()
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+
+			while (true)
+			{
+				requestReady.wait(lock, [this] { return isStopping || !requests.empty(); });
+				if (isStopping)
+					return;
+
+				auto nextRequest = std::min_element(requests.begin(), requests.end(),
+					[](const SceneRequest& _a, const SceneRequest& _b) { return _a.priority < _b.priority; });
+
+				SceneRequest request = std::move(*nextRequest);
+				requests.erase(nextRequest);
+				preparingScene = request.sceneIndex;
+				UINT64 generation = clearGeneration;
+				lock.unlock();
+
+				std::shared_ptr<SceneSpawnBatch> batch = PrepareRequest(request);
+
+				lock.lock();
+				preparingScene = -1;
+				if (generation == clearGeneration)
+					readyBatches.push_back(std::move(batch));
+				batchReady.notify_all();
+			}
+		}
+	};
+};
+
+#endif
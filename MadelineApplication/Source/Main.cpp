@@ -1,5 +1,6 @@
 // handles everything
 #include "Application.h"
+#include "Loaders/SaveLoaderTests.h"
 #define _CRTDBG_MAP_ALLOC
 #include <stdlib.h>
 #include <crtdbg.h>
@@ -12,10 +13,35 @@ void CheckMemoryLeaks()
 }
 
 // program entry point
-int main()
+int main(int argc, char* argv[])
 {
 	//_CrtSetBreakAlloc(0);
 
+	// --cook imports every FBX whose cooked model is missing or stale and exits, without opening a window
+	if (argc > 1 && strcmp(argv[1], "--cook") == 0)
+	{
+		GW::SYSTEM::GLog log;
+		log.Create("cook.log");
+		log.EnableConsoleLogging(true);
+
+		MAD::ModelLoader cooker;
+		return cooker.CookModels(std::make_shared<GameConfig>(), log) ? 0 : 1;
+	}
+
+	// --test-saves [scene count] checks and times the save files on generated scenes, 1024 unless a count is given
+	if (argc > 1 && strcmp(argv[1], "--test-saves") == 0)
+	{
+		MAD::SaveLoaderTests tests;
+		return tests.Run(std::make_shared<GameConfig>(), argc > 2 ? (unsigned)atoi(argv[2]) : 1024) ? 0 : 1;
+	}
+
+	// Started by --test-saves, which kills it while it saves
+	if (argc > 2 && strcmp(argv[1], "--write-save-slots") == 0)
+	{
+		MAD::SaveLoaderTests::WriteSaveSlotsUntilKilled(argv[2]);
+		return 1;
+	}
+
 	Application madeline;
 	if (madeline.Init()) {
 		if (madeline.Run()) {
@@ -107,7 +107,9 @@ void MAD::CameraLogic::InitCameraSystem()
 			if (!inLevelEditor && playerTransformQuery.count() > 0)
 			{
 				// Follow player
-				GW::MATH::GVECTORF targetPos = playerTransformQuery.first().get<Transform>()->value.row4;
+				flecs::entity player = playerTransformQuery.first();
+				const InterpolatedTransform* interpolated = player.get<InterpolatedTransform>();
+				GW::MATH::GVECTORF targetPos = interpolated ? interpolated->value.row4 : player.get<Transform>()->value.row4;
 				targetPos.z += zOffset;
 				targetPos = ClampToSafeArea(targetPos);
 
@@ -69,6 +69,15 @@ bool MAD::GameLogic::Init(
 				flecsWorldLock.UnlockSyncWrite();
 			});
 
+	timerWheel = std::make_shared<TimerWheel>();
+	struct TimerSystem {};
+	flecsWorld->entity("Timer System").add<TimerSystem>();
+	flecsWorld->system<TimerSystem>()
+		.each([this](flecs::entity _entity, TimerSystem&)
+			{
+				timerWheel->Advance(_entity.delta_time());
+			});
+
 	if (InitInput() == false)
 		return false;
 	if (InitEvents() == false)
@@ -112,14 +121,12 @@ bool MAD::GameLogic::InitEvents()
 					if (inWinPause)
 						break;
 					inWinPause = true;
-					winGamePause.Create(1, [&]()
+					timerWheel->Schedule(winPauseTime, [this]()
 						{
 							SwitchGameState(GAME_STATE::MAIN_MENU);
 							GameplayStop();
 							inWinPause = false;
-
-							winGamePause.Pause(0, false);
-						}, winPauseTime);
+						});
 					break;
 				}
 				default:
@@ -383,9 +390,10 @@ bool::MAD::GameLogic::GameplayStart()
 			levelEventPusher,
 			gameConfig,
 			saveLoader,
+			timerWheel,
 			tileData) == false)
 			return false;
-		if (physicsLogic.Init(flecsWorld, gameConfig, levelEventPusher) == false)
+		if (physicsLogic.Init(flecsWorld, gameConfig, levelEventPusher, saveLoader) == false)
 			return false;
 		if (tileLogic.Init(
 			flecsWorld,
@@ -394,8 +402,17 @@ bool::MAD::GameLogic::GameplayStart()
 			levelEventPusher,
 			gameStateEventPusher,
 			touchEventPusher,
-			saveLoader) == false)
+			saveLoader,
+			timerWheel) == false)
 			return false;
+		physicsLogic.AddContactListener([this](const ContactEvents& _contactEvents)
+			{
+				tileLogic.HandleContactEvents(_contactEvents);
+			});
+		physicsLogic.AddContactListener([this](const ContactEvents& _contactEvents)
+			{
+				playerLogic.HandleContactEvents(_contactEvents);
+			});
 		if (cameraLogic.Init(flecsWorld, gameConfig, gameStateEventPusher, cameraEventPusher, saveLoader, renderer) == false)
 			return false;
 		if (levelEditorLogic.Init(
@@ -433,6 +450,10 @@ void MAD::GameLogic::GameplayStop()
 		});
 	flecsWorldLock.UnlockSyncWrite();
 
+	// Pending timers belong to the entities just destroyed
+	timerWheel->Clear();
+	inWinPause = false;
+
 	playerLogic.GameplayStop();
 }
 
@@ -445,6 +466,7 @@ void MAD::GameLogic::PauseSystems()
 	levelEditorLogic.Activate(false);
 	tileLogic.Activate(false);
 	animationLogic.Activate(false);
+	flecsWorld->entity("Timer System").disable();
 }
 
 void MAD::GameLogic::PlaySystems()
@@ -456,6 +478,7 @@ void MAD::GameLogic::PlaySystems()
 	levelEditorLogic.Activate(true);
 	tileLogic.Activate(true);
 	animationLogic.Activate(true);
+	flecsWorld->entity("Timer System").enable();
 }
 
 void MAD::GameLogic::FadeInEvent()
@@ -521,6 +544,8 @@ bool MAD::GameLogic::Shutdown()
 		return false;
 
 	flecsWorld->entity("Merge Async Stages").destruct();
+	flecsWorld->entity("Timer System").destruct();
+	timerWheel.reset();
 
 	flecsWorld.reset();
 	gameConfig.reset();
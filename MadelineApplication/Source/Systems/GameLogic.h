@@ -14,6 +14,8 @@
 #include "../Entities/TileData.h"
 #include "../Loaders/DelayLoad.h"
 
+#include "../Utils/TimerWheel.h"
+
 
 namespace MAD
 {
@@ -45,7 +47,8 @@ namespace MAD
 		GW::CORE::GEventResponder playEventResponder;
 		std::weak_ptr<GameConfig> gameConfig;
 
-		GW::SYSTEM::GDaemon winGamePause{};
+		// Gameplay timers, ticked by the Timer System so they stop whenever gameplay is paused
+		std::shared_ptr<TimerWheel> timerWheel;
 
 		MAD::LevelLogic levelLogic;
 		MAD::PhysicsLogic physicsLogic;
@@ -460,8 +460,10 @@ void MAD::LevelEditorLogic::SelectSpawnpointScene(GVECTORF _worldPos)
 
 	std::shared_ptr<Tilemap> spawnpointScene = saveLoader->GetScene(spawnpointSceneIndex);
 
-	TilemapTile* spawnpointTile = spawnpointScene->GetTile(newSpawnpointPos);
-	spawnpointTile->orientationId = otherSceneIndex;
+	int spawnpointRow = newSpawnpointPos.y - spawnpointScene->originY;
+	int spawnpointCol = newSpawnpointPos.x - spawnpointScene->originX;
+	const TilemapTile* spawnpointTile = spawnpointScene->GetTile(spawnpointRow, spawnpointCol);
+	spawnpointScene->SetTile(spawnpointRow, spawnpointCol, { spawnpointTile->tilesetId, (USHORT)otherSceneIndex });
 	spawnpointScene->AddSpawnpoint(_worldPos, otherSceneIndex);
 	LogChange(spawnpointSceneIndex);
 
@@ -538,7 +540,7 @@ void MAD::LevelEditorLogic::AddTile(GVECTORF _worldPos)
 	}
 	}
 
-	curScene->tiles.at(sceneRow).at(sceneCol) = { curTilesetId, orientation };
+	curScene->SetTile(sceneRow, sceneCol, { curTilesetId, orientation });
 	LogChange(curSceneIndex);
 
 	EDITOR_EVENT_DATA eventData
@@ -578,8 +580,8 @@ void MAD::LevelEditorLogic::RemoveTile(GVECTORF _worldPos)
 	if (tile == NULL || tile->tilesetId == 0)
 		return;
 
-	TilemapTile previousTile = curScene->tiles.at(sceneRow).at(sceneCol);
-	curScene->tiles.at(sceneRow).at(sceneCol) = { 0, 0 };
+	TilemapTile previousTile = *tile;
+	curScene->SetTile(sceneRow, sceneCol, { 0, 0 });
 
 	switch (previousTile.tilesetId)
 	{
@@ -645,10 +647,8 @@ int MAD::LevelEditorLogic::GetAdjacentSceneAtPoint(GVECTORF _worldPos)
 
 void MAD::LevelEditorLogic::SaveScenes()
 {
-	for (unsigned i : unsavedScenes)
-	{
-		saveLoader->SaveScene(i);
-	}
+	if (!unsavedScenes.empty())
+		saveLoader->SaveSceneChanges();
 
 	unsavedScenes.clear();
 }
@@ -21,6 +21,7 @@ bool LevelLogic::Init(
 	GEventGenerator _levelEventPusher,
 	std::weak_ptr<const GameConfig> _gameConfig,
 	std::shared_ptr<SaveLoader> _saveLoader,
+	std::shared_ptr<TimerWheel> _timerWheel,
 	TileData* _tileData)
 {
 	flecsWorld = _flecsWorld;
@@ -34,19 +35,36 @@ bool LevelLogic::Init(
 	levelEventPusher = _levelEventPusher;
 
 	saveLoader = _saveLoader;
+	timerWheel = _timerWheel;
 
 	tileData = _tileData;
 
-	tileQuery = flecsWorld->query<Tile>();
 	playerQuery = flecsWorld->query<Player>();
+	followingTileQuery = flecsWorld->query<Tile, FollowPlayer>();
 
 	std::shared_ptr<const GameConfig> readCfg = gameConfig.lock();
 
 	sceneExitTime = readCfg->at("SceneExit").at("exitTime").as<unsigned>();
 	respawnPauseTime = readCfg->at("Spawnpoint").at("respawnPauseTime").as<unsigned>();
+	mergeTileColliders = readCfg->at("Physics").at("mergeTileColliders").as<bool>();
+	logStats = readCfg->at("Physics").at("logStats").as<bool>();
+	streamBudget = readCfg->at("Scenes").at("streamBudget").as<float>();
+	streamLookahead = readCfg->at("Scenes").at("streamLookahead").as<float>();
+	maxLoadedScenes = readCfg->at("Scenes").at("maxLoadedScenes").as<unsigned>();
+	tilePoolMaxBytes = (size_t)readCfg->at("Scenes").at("tilePoolMemory").as<unsigned>() * 1024;
+	tilePoolBytes = 0;
+	streamStallMilliseconds = 0;
+	streamStalls = 0;
 
 	InitEventHandlers();
 	InitMergeAsyncSystem();
+	InitStreamingSystem();
+	InitFollowPlayerObserver();
+
+	BuildTileCollisions();
+	saveLoader->SetTileCollisionClassifier([this](const TilemapTile& _tile) { return GetTileCollision(_tile); });
+
+	sceneStreamer.Start(mergeTileColliders, [this](const SceneSource& _source) { return saveLoader->DecodeSceneSource(_source); });
 
 	return true;
 }
@@ -167,12 +185,47 @@ void MAD::LevelLogic::InitMergeAsyncSystem()
 				flecsWorldLock.UnlockSyncWrite();
 			});
 }
+
+// Runs on the world instead of a readonly stage so streamed tiles can be bulk spawned. Systems still run deferred,
+// ending it flushes what's queued so far and lets the scene commit straight to the world, in order.
+void MAD::LevelLogic::InitStreamingSystem()
+{
+	struct SceneStreaming {};
+	flecsWorld->entity("Scene Streaming System").add<SceneStreaming>();
+	flecsWorld->system<SceneStreaming>()
+		.kind(OnLoad)
+		.no_readonly()
+		.each([this](entity _entity, SceneStreaming& _sceneStreaming)
+			{
+				flecsWorld->defer_end();
+				UpdateStreaming();
+				flecsWorld->defer_begin();
+			});
+}
+
+// A strawberry following the player leaves its scene so it stays visible when the scene is hidden,
+// and rejoins it once it's back in place or collected
+void MAD::LevelLogic::InitFollowPlayerObserver()
+{
+	followPlayerObserver = flecsWorld->observer<Tile, FollowPlayer>()
+		.event(OnAdd)
+		.event(OnRemove)
+		.each([this](iter& _it, size_t _i, Tile& _tile, FollowPlayer&)
+			{
+				entity follower = _it.entity(_i);
+
+				if (_it.event() == OnAdd)
+					follower.remove<InScene>(Wildcard);
+				else
+					follower.add<InScene>(GetSceneEntities(_tile.sceneIndex).scene);
+			});
+}
 #pragma endregion
 
 #pragma region Play Events
 void MAD::LevelLogic::OnPlayerDestroyed(PLAY_EVENT_DATA _data)
 {
-	respawnPause.Create(1, [&]()
+	timerWheel->Schedule(respawnPauseTime, [this]()
 		{
 			std::shared_ptr<Tilemap> scene = saveLoader->GetScene(saveLoader->GetSaveSlot().sceneIndex);
 			const Spawnpoint* spawnpoint = scene->GetSpawnpointByScene(saveLoader->GetSaveSlot().prevSceneIndex);
@@ -191,29 +244,47 @@ void MAD::LevelLogic::OnPlayerDestroyed(PLAY_EVENT_DATA _data)
 			playerQuery.first().add<RenderModel>();
 			playerQuery.first().add<Collidable>();
 			playerQuery.first().add<Moveable>();
-
-			respawnPause.Pause(0, false);
-		}, respawnPauseTime);
+		});
 }
 #pragma endregion
 
 #pragma region Editor Events
 void MAD::LevelLogic::OnAddTile(EDITOR_EVENT_DATA _data)
 {
+	FinishStreamingScene(_data.sceneIndex);
+
 	TilemapTile tile = { _data.tileset, _data.orientation };
+	saveLoader->GetScene(_data.sceneIndex)->SetTileCollision(_data.sceneRow, _data.sceneCol, GetTileCollision(tile));
+
 	SpawnTile(
 		tile,
 		saveLoader->GetScene(_data.sceneIndex),
 		_data.sceneIndex,
 		_data.sceneRow,
 		_data.sceneCol);
+
+	if (mergeTileColliders)
+	{
+		DestroyCompoundColliders(_data.sceneIndex);
+		SpawnCompoundColliders(saveLoader->GetScene(_data.sceneIndex), _data.sceneIndex);
+	}
 }
 
 void MAD::LevelLogic::OnRemoveTile(EDITOR_EVENT_DATA _data)
 {
-	std::string name = GetTileName(_data);
-	if (!name.empty())
-		flecsWorld->entity(name.c_str()).destruct();
+	FinishStreamingScene(_data.sceneIndex);
+
+	flecs::entity_t tile = RemoveTileEntity(_data.sceneIndex, (USHORT)_data.sceneRow, (USHORT)_data.sceneCol);
+	if (tile != 0)
+		DestroyEntity(tile);
+
+	saveLoader->GetScene(_data.sceneIndex)->SetTileCollision(_data.sceneRow, _data.sceneCol, TILE_COLLISION_NONE);
+
+	if (mergeTileColliders)
+	{
+		DestroyCompoundColliders(_data.sceneIndex);
+		SpawnCompoundColliders(saveLoader->GetScene(_data.sceneIndex), _data.sceneIndex);
+	}
 }
 #pragma endregion
 
@@ -274,7 +345,7 @@ void LevelLogic::SpawnPlayer()
 
 		ColliderContainer colliders(*playerPrefab.get<ColliderContainer>(), spawnedPlayer, transform.row4);
 
-		spawnedPlayer.set<ColliderContainer>(colliders);
+		spawnedPlayer.set<ColliderContainer>(std::move(colliders));
 		flecsWorldLock.UnlockSyncWrite();
 
 	}
@@ -283,6 +354,7 @@ void LevelLogic::SpawnPlayer()
 #pragma endregion
 
 #pragma region Tiles
+// Spawns a single tile through the async stage, for edits and scenes loaded while the world is readonly
 void MAD::LevelLogic::SpawnTile(
 	const TilemapTile& _tile,
 	std::shared_ptr<Tilemap> _scene,
@@ -294,75 +366,551 @@ void MAD::LevelLogic::SpawnTile(
 	std::string prefabName = tileData->GetTilePrefabName(_tile.tilesetId, _tile.orientationId);
 	if (RetreivePrefab(prefabName.c_str(), tilePrefab))
 	{
-		std::string tileName = GetTileName(_tile.tilesetId, _tile.orientationId, _sceneIndex, _sceneRow, _sceneCol);
-
 		GMATRIXF transform = tilePrefab.get<Transform>()->value;
 		transform.row4.x += _scene->originX + _sceneCol;
 		transform.row4.y += _scene->originY + _sceneRow;
 
 		Tile tileInfo = { _sceneIndex, (USHORT)_sceneRow, (USHORT)_sceneCol };
+		UCHAR spawnFlags = GetTileSpawnFlags(_tile, _sceneIndex, tilePrefab);
 
 		flecsWorldLock.LockSyncWrite();
-		flecs::entity spawnedTile = flecsWorldAsync.entity(tileName.c_str()).is_a(tilePrefab)
+		flecs::entity spawnedTile = flecsWorldAsync.entity().is_a(tilePrefab)
+			.add<InScene>(GetSceneEntities(_sceneIndex).scene)
 			.set<Transform>({ transform })
 			.set<Tile>(tileInfo);
 
-		if (_tile.tilesetId == STRAWBERRY_ID)
-		{
+		if (spawnFlags & SPAWN_STRAWBERRY)
 			spawnedTile.set<Strawberry>({ transform.row4 });
+		if (spawnFlags & SPAWN_COLLECTED)
+		{
+			spawnedTile.add<Collected>();
+			spawnedTile.add<RenderInEditor>();
+		}
+		if (spawnFlags & SPAWN_IN_COMPOUND_COLLIDER)
+			spawnedTile.add<InCompoundCollider>();
+		if (spawnFlags & SPAWN_COLLIDABLE)
+			spawnedTile.add<Collidable>();
+		if (spawnFlags & SPAWN_RENDER_MODEL)
+			spawnedTile.add<RenderModel>();
+		if (spawnFlags & SPAWN_COLLIDERS)
+			spawnedTile.set<ColliderContainer>(GetTileColliders(_tile, tilePrefab, spawnedTile, transform.row4));
+		flecsWorldLock.UnlockSyncWrite();
 
-			if (saveLoader->GetSaveSlot().IsStrawberryCollected(_sceneIndex))
-			{
-				spawnedTile.add<Collected>();
-				spawnedTile.add<RenderInEditor>();
+		AddTileEntity(tileInfo.sceneIndex, tileInfo.sceneRow, tileInfo.sceneCol, spawnedTile.id());
+	}
+}
 
-				if (curGameState == LEVEL_EDITOR)
-					spawnedTile.add<RenderModel>();
-			}
-			else
-			{
-				spawnedTile.add<Collidable>();
-				spawnedTile.add<RenderModel>();
-			}
+// Creates tiles straight into their tables with ecs_bulk_init, which needs the world to not be deferred so
+// nothing queued lands after the tiles and observers see them whole. Tiles of one prefab spawning with the same components share a table, so each such group is one bulk call
+// with its component columns built up front instead of one entity, name and set at a time.
+// Pooled tiles of the group's prefab are reused first, returns how many were.
+size_t MAD::LevelLogic::BulkSpawnTiles(const TileSpawn* _spawns, size_t _count, std::shared_ptr<Tilemap> _scene, USHORT _sceneIndex)
+{
+	struct TileGroup
+	{
+		flecs::entity prefab;
+		UCHAR spawnFlags;
+		std::vector<const TileSpawn*> spawns;
+	};
+
+	std::vector<TileGroup> groups;
+	// Keyed by tilesetId << 16 | orientationId, then by spawn flags below that
+	std::unordered_map<UINT64, size_t> groupIndices;
+	std::unordered_map<UINT32, flecs::entity> tilePrefabs;
+
+	for (size_t i = 0; i < _count; i++)
+	{
+		const TileSpawn& spawn = _spawns[i];
+		UINT32 prefabKey = ((UINT32)spawn.tile.tilesetId << 16) | spawn.tile.orientationId;
+
+		auto tilePrefab = tilePrefabs.find(prefabKey);
+		if (tilePrefab == tilePrefabs.end())
+		{
+			flecs::entity prefab{};
+			RetreivePrefab(tileData->GetTilePrefabName(spawn.tile.tilesetId, spawn.tile.orientationId).c_str(), prefab);
+			tilePrefab = tilePrefabs.insert({ prefabKey, prefab }).first;
+		}
+		if (tilePrefab->second.id() == 0)
+			continue;
+
+		UCHAR spawnFlags = GetTileSpawnFlags(spawn.tile, _sceneIndex, tilePrefab->second);
+		UINT64 groupKey = ((UINT64)prefabKey << 8) | spawnFlags;
+
+		auto groupIndex = groupIndices.find(groupKey);
+		if (groupIndex == groupIndices.end())
+		{
+			groupIndex = groupIndices.insert({ groupKey, groups.size() }).first;
+			groups.push_back({ tilePrefab->second, spawnFlags, {} });
+		}
+		groups[groupIndex->second].spawns.push_back(&spawn);
+	}
+
+	size_t reusedCount = 0;
+	for (const TileGroup& group : groups)
+	{
+		const GMATRIXF& prefabTransform = group.prefab.get<Transform>()->value;
+		size_t first = 0;
+
+		for (; first < group.spawns.size(); first++)
+		{
+			flecs::entity_t pooledTile = TakePooledTile(group.prefab);
+			if (pooledTile == 0)
+				break;
+
+			const TileSpawn& spawn = *group.spawns[first];
+			GMATRIXF transform = prefabTransform;
+			transform.row4.x += _scene->originX + spawn.col;
+			transform.row4.y += _scene->originY + spawn.row;
+
+			Tile tileInfo = { _sceneIndex, spawn.row, spawn.col };
+			ReuseTile(flecsWorld->entity(pooledTile), spawn.tile, group.prefab, _sceneIndex, group.spawnFlags, tileInfo, transform);
+			AddTileEntity(_sceneIndex, spawn.row, spawn.col, pooledTile);
+		}
+		reusedCount += first;
+
+		size_t count = group.spawns.size() - first;
+		if (count == 0)
+			continue;
+
+		// Ids are made first so the colliders can be built with their owners
+		std::vector<flecs::entity_t> entities(count);
+		std::vector<Transform> transforms;
+		std::vector<Tile> tiles;
+		std::vector<Strawberry> strawberries;
+		std::vector<ColliderContainer> colliders;
+		transforms.reserve(count);
+		tiles.reserve(count);
+		if (group.spawnFlags & SPAWN_STRAWBERRY)
+			strawberries.reserve(count);
+		if (group.spawnFlags & SPAWN_COLLIDERS)
+			colliders.reserve(count);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const TileSpawn& spawn = *group.spawns[first + i];
+			entities[i] = ecs_new_id(*flecsWorld);
+
+			GMATRIXF transform = prefabTransform;
+			transform.row4.x += _scene->originX + spawn.col;
+			transform.row4.y += _scene->originY + spawn.row;
+
+			transforms.push_back({ transform });
+			tiles.push_back({ _sceneIndex, spawn.row, spawn.col });
+			if (group.spawnFlags & SPAWN_STRAWBERRY)
+				strawberries.push_back({ transform.row4 });
+			if (group.spawnFlags & SPAWN_COLLIDERS)
+				colliders.push_back(GetTileColliders(spawn.tile, group.prefab, flecs::id(entities[i]), transform.row4));
+
+			AddTileEntity(_sceneIndex, spawn.row, spawn.col, entities[i]);
+		}
+
+		// Data is moved into the table's columns, tags and the prefab pair have none
+		ecs_bulk_desc_t desc = {};
+		void* componentData[ECS_ID_CACHE_SIZE] = {};
+		int id = 0;
+
+		desc.ids[id++] = ecs_pair(EcsIsA, group.prefab.id());
+		desc.ids[id++] = ecs_pair(flecsWorld->id<InScene>(), GetSceneEntities(_sceneIndex).scene);
+		componentData[id] = transforms.data();
+		desc.ids[id++] = flecsWorld->id<Transform>();
+		componentData[id] = tiles.data();
+		desc.ids[id++] = flecsWorld->id<Tile>();
+		if (group.spawnFlags & SPAWN_STRAWBERRY)
+		{
+			componentData[id] = strawberries.data();
+			desc.ids[id++] = flecsWorld->id<Strawberry>();
+		}
+		if (group.spawnFlags & SPAWN_COLLIDERS)
+		{
+			componentData[id] = colliders.data();
+			desc.ids[id++] = flecsWorld->id<ColliderContainer>();
+		}
+		if (group.spawnFlags & SPAWN_COLLECTED)
+		{
+			desc.ids[id++] = flecsWorld->id<Collected>();
+			desc.ids[id++] = flecsWorld->id<RenderInEditor>();
+		}
+		if (group.spawnFlags & SPAWN_IN_COMPOUND_COLLIDER)
+			desc.ids[id++] = flecsWorld->id<InCompoundCollider>();
+		if (group.spawnFlags & SPAWN_COLLIDABLE)
+			desc.ids[id++] = flecsWorld->id<Collidable>();
+		if (group.spawnFlags & SPAWN_RENDER_MODEL)
+			desc.ids[id++] = flecsWorld->id<RenderModel>();
+
+		desc.entities = entities.data();
+		desc.count = (int32_t)count;
+		desc.data = componentData;
+		ecs_bulk_init(*flecsWorld, &desc);
+	}
+
+	return reusedCount;
+}
+
+UCHAR MAD::LevelLogic::GetTileSpawnFlags(const TilemapTile& _tile, USHORT _sceneIndex, flecs::entity _tilePrefab)
+{
+	UCHAR spawnFlags = 0;
+
+	if (_tile.tilesetId == STRAWBERRY_ID)
+	{
+		spawnFlags |= SPAWN_STRAWBERRY | SPAWN_COLLIDERS;
+
+		if (saveLoader->GetSaveSlot().IsStrawberryCollected(_sceneIndex))
+		{
+			spawnFlags |= SPAWN_COLLECTED;
+
+			if (curGameState == LEVEL_EDITOR)
+				spawnFlags |= SPAWN_RENDER_MODEL;
 		}
 		else
+			spawnFlags |= SPAWN_COLLIDABLE | SPAWN_RENDER_MODEL;
+
+		return spawnFlags;
+	}
+
+	// Collision comes from the scene's compound colliders, the tile only renders
+	if (mergeTileColliders && IsMergeableTile(_tile))
+		spawnFlags |= SPAWN_IN_COMPOUND_COLLIDER;
+	else
+		spawnFlags |= SPAWN_COLLIDABLE | SPAWN_COLLIDERS;
+
+	if (!_tilePrefab.has<RenderInEditor>() || curGameState == LEVEL_EDITOR)
+		spawnFlags |= SPAWN_RENDER_MODEL;
+
+	return spawnFlags;
+}
+
+ColliderContainer MAD::LevelLogic::GetTileColliders(const TilemapTile& _tile, flecs::entity _tilePrefab, flecs::id _ownerId, const GVECTORF& _position)
+{
+	ColliderContainer colliders(*_tilePrefab.get<ColliderContainer>(), _ownerId, _position);
+	colliders.isTerrain = GetTileCollision(_tile) != TILE_COLLISION_NONE;
+	return colliders;
+}
+
+MAD::LevelLogic::SceneEntities& MAD::LevelLogic::GetSceneEntities(USHORT _sceneIndex)
+{
+	if (sceneEntities.size() <= _sceneIndex)
+		sceneEntities.resize((size_t)_sceneIndex + 1);
+
+	SceneEntities& entities = sceneEntities[_sceneIndex];
+	if (entities.scene == 0)
+		entities.scene = flecsWorld->entity().id();
+
+	// Only the bounds are needed, so a scene that's still archived isn't decoded for them
+	if (entities.cells.empty() && _sceneIndex < saveLoader->GetAllScenes().size())
+	{
+		const Tilemap& scene = *saveLoader->GetAllScenes()[_sceneIndex];
+		entities.columns = scene.columns;
+		entities.cells.assign((size_t)scene.rows * scene.columns, 0);
+	}
+
+	return entities;
+}
+
+void MAD::LevelLogic::AddTileEntity(USHORT _sceneIndex, USHORT _sceneRow, USHORT _sceneCol, flecs::entity_t _entity)
+{
+	SceneEntities& entities = GetSceneEntities(_sceneIndex);
+	size_t cell = (size_t)_sceneRow * entities.columns + _sceneCol;
+	if (_sceneCol >= entities.columns || cell >= entities.cells.size())
+		return;
+
+	entities.cells[cell] = _entity;
+	entities.tiles.push_back(_entity);
+}
+
+// Forgets the tile in the cell and returns it, or 0 if the cell is empty
+flecs::entity_t MAD::LevelLogic::RemoveTileEntity(USHORT _sceneIndex, USHORT _sceneRow, USHORT _sceneCol)
+{
+	SceneEntities& entities = GetSceneEntities(_sceneIndex);
+	size_t cell = (size_t)_sceneRow * entities.columns + _sceneCol;
+	if (_sceneCol >= entities.columns || cell >= entities.cells.size() || entities.cells[cell] == 0)
+		return 0;
+
+	flecs::entity_t tile = entities.cells[cell];
+	entities.cells[cell] = 0;
+
+	auto sceneTile = std::find(entities.tiles.begin(), entities.tiles.end(), tile);
+	if (sceneTile != entities.tiles.end())
+	{
+		*sceneTile = entities.tiles.back();
+		entities.tiles.pop_back();
+	}
+
+	return tile;
+}
+
+// Entities spawned through the async stage are alive before they're merged, destroying them drops what's pending
+void MAD::LevelLogic::DestroyEntity(flecs::entity_t _entity)
+{
+	if (_entity != 0 && flecsWorld->is_alive(_entity))
+		flecsWorld->entity(_entity).destruct();
+}
+
+// Disables the tile and keeps it for its prefab's next spawn, or destroys it when the pool is full.
+// Queries skip disabled entities, so a pooled tile keeps its components without being drawn or collided with.
+void MAD::LevelLogic::PoolTile(flecs::entity_t _tile)
+{
+	if (_tile == 0 || !flecsWorld->is_alive(_tile))
+		return;
+
+	entity tile = flecsWorld->entity(_tile);
+	// Tiles still waiting on the async stage have no prefab yet
+	flecs::entity_t tilePrefab = tile.target(IsA).id();
+	size_t bytes = GetPooledTileBytes(tile);
+
+	if (tilePrefab == 0 || tile.has<FollowPlayer>() || tilePoolBytes + bytes > tilePoolMaxBytes)
+	{
+		tile.destruct();
+		return;
+	}
+
+	// The tile's crumble or respawn would otherwise land wherever it's reused
+	const TileTimers* timers = tile.get<TileTimers>();
+	if (timers != nullptr)
+	{
+		for (TimerWheel::Handle handle : timers->handles)
+			timerWheel->Cancel(handle);
+	}
+
+	tile.remove<InScene>(Wildcard)
+		.remove<Touched>()
+		.remove<Crumbled>()
+		.remove<TileTimers>()
+		.disable();
+
+	tilePool[tilePrefab].push_back({ _tile, bytes });
+	tilePoolBytes += bytes;
+}
+
+// A pooled tile of the prefab, or 0 if there are none
+flecs::entity_t MAD::LevelLogic::TakePooledTile(flecs::entity_t _tilePrefab)
+{
+	auto pooledTiles = tilePool.find(_tilePrefab);
+	if (pooledTiles == tilePool.end())
+		return 0;
+
+	while (!pooledTiles->second.empty())
+	{
+		PooledTile pooledTile = pooledTiles->second.back();
+		pooledTiles->second.pop_back();
+		tilePoolBytes -= pooledTile.bytes;
+
+		if (flecsWorld->is_alive(pooledTile.entity))
+			return pooledTile.entity;
+	}
+
+	return 0;
+}
+
+// Rebinds a pooled tile to its new cell and gives it the components it would have spawned with.
+// Only called while bulk spawning, so every write lands right away.
+void MAD::LevelLogic::ReuseTile(
+	flecs::entity _tile, 
+	const TilemapTile& _tileType, 
+	flecs::entity _tilePrefab, 
+	USHORT _sceneIndex, 
+	UCHAR _spawnFlags, 
+	const Tile& _tileInfo, 
+	const GMATRIXF& _transform)
+{
+	_tile.set<Transform>({ _transform })
+		.set<Tile>(_tileInfo);
+
+	if (_spawnFlags & SPAWN_STRAWBERRY)
+		_tile.set<Strawberry>({ _transform.row4 });
+
+	if (_spawnFlags & SPAWN_COLLIDERS)
+	{
+		// Colliders the tile was spawned with are moved in place, only override copies of the prefab's are rebuilt
+		ColliderContainer* colliders = _tile.get_mut<ColliderContainer>();
+		if (colliders->ownerId == _tile.id())
+			colliders->UpdateWorldPosition(_transform.row4);
+		else
+			*colliders = GetTileColliders(_tileType, _tilePrefab, _tile, _transform.row4);
+		_tile.modified<ColliderContainer>();
+	}
+
+	auto setTag = [&_tile](flecs::id_t _tag, bool _hasTag)
 		{
-			spawnedTile.add<Collidable>();
+			if (_hasTag)
+				_tile.add(_tag);
+			else
+				_tile.remove(_tag);
+		};
+
+	setTag(flecsWorld->id<Collected>(), (_spawnFlags & SPAWN_COLLECTED) != 0);
+	setTag(flecsWorld->id<RenderInEditor>(), (_spawnFlags & SPAWN_COLLECTED) != 0);
+	setTag(flecsWorld->id<InCompoundCollider>(), (_spawnFlags & SPAWN_IN_COMPOUND_COLLIDER) != 0);
+	setTag(flecsWorld->id<Collidable>(), (_spawnFlags & SPAWN_COLLIDABLE) != 0);
+	setTag(flecsWorld->id<RenderModel>(), (_spawnFlags & SPAWN_RENDER_MODEL) != 0);
+
+	_tile.add<InScene>(GetSceneEntities(_sceneIndex).scene)
+		.enable();
+}
+
+void MAD::LevelLogic::ClearTilePool()
+{
+	for (auto& pooledTiles : tilePool)
+	{
+		for (const PooledTile& pooledTile : pooledTiles.second)
+			DestroyEntity(pooledTile.entity);
+	}
+
+	tilePool.clear();
+	tilePoolBytes = 0;
+}
+
+// Rough size of the tile's own components and collider storage
+size_t MAD::LevelLogic::GetPooledTileBytes(flecs::entity _tile)
+{
+	size_t bytes = sizeof(flecs::entity_t) + sizeof(Transform) + sizeof(Tile);
+
+	if (_tile.owns<Strawberry>())
+		bytes += sizeof(Strawberry);
+
+	const ColliderContainer* colliders = _tile.get<ColliderContainer>();
+	if (colliders != nullptr && _tile.owns<ColliderContainer>())
+	{
+		bytes += sizeof(ColliderContainer) +
+			(colliders->colliders.capacity() + colliders->triggerColliders.capacity() + colliders->physicsColliders.capacity()) * sizeof(std::shared_ptr<Collider>);
+
+		// Override copies share the prefab's colliders, make_shared puts each collider next to its control block
+		if (colliders->ownerId == _tile.id())
+			bytes += colliders->colliders.size() * (sizeof(BoxCollider) + 2 * sizeof(long));
+	}
+
+	return bytes;
+}
 
-			if (!tilePrefab.has<RenderInEditor>() || curGameState == LEVEL_EDITOR)
-				spawnedTile.add<RenderModel>();
+// Classifies every tile prefab up front, so looking a tile up never touches the world
+void MAD::LevelLogic::BuildTileCollisions()
+{
+	tileCollisions.assign(tileData->tilesetNames.size(), {});
+
+	// Tileset 0 is empty space
+	for (unsigned tilesetId = 1; tilesetId < tileData->tilesetNames.size(); tilesetId++)
+	{
+		const std::vector<std::string>& prefabNames = tileData->tilePrefabNames.at(tileData->tilesetNames[tilesetId]);
+
+		for (const std::string& prefabName : prefabNames)
+		{
+			flecs::entity tilePrefab{};
+			tileCollisions[tilesetId].push_back(
+				RetreivePrefab(prefabName.c_str(), tilePrefab) ? ClassifyTilePrefab(tilePrefab) : TILE_COLLISION_NONE);
 		}
+	}
+}
 
-		ColliderContainer colliders(*tilePrefab.get<ColliderContainer>(), spawnedTile, transform.row4);
+// Static tiles on the default layers with a single box that fills their whole cell are solid,
+// one way boxes that span the cell's width and reach its top are one way. Anything else keeps its own collider.
+TileCollision MAD::LevelLogic::ClassifyTilePrefab(flecs::entity _tilePrefab)
+{
+	if (!_tilePrefab.has<PhysicsCollidable>() ||
+		_tilePrefab.has<Triggerable>() ||
+		_tilePrefab.has<CrumblingPlatform>())
+		return TILE_COLLISION_NONE;
+
+	const ColliderContainer* colliders = _tilePrefab.get<ColliderContainer>();
+	const GVECTORF& offset = _tilePrefab.get<Transform>()->value.row4;
+
+	if (colliders == nullptr ||
+		colliders->colliders.size() != 1 ||
+		colliders->physicsColliders.size() != 1 ||
+		colliders->physicsColliders[0]->type != BOX ||
+		colliders->physicsColliders[0]->category != COLLISION_LAYER_DEFAULT ||
+		colliders->physicsColliders[0]->mask != COLLISION_LAYER_ALL ||
+		offset.x != 0 || offset.y != 0)
+		return TILE_COLLISION_NONE;
+
+	const BoxCollider* box = (const BoxCollider*)colliders->physicsColliders[0].get();
+	bool isFullWidth = box->localPos.x == 0 && box->size.x == 1;
+
+	if (!box->isOneWay && isFullWidth && box->localPos.y == 0 && box->size.y == 1)
+		return TILE_COLLISION_SOLID;
+	else if (box->isOneWay && isFullWidth && box->localPos.y + box->size.y * .5f == .5f)
+		return TILE_COLLISION_ONE_WAY;
+
+	return TILE_COLLISION_NONE;
+}
 
-		spawnedTile.set<ColliderContainer>(colliders);
-		flecsWorldLock.UnlockSyncWrite();
+// Orientations past a tileset's prefabs use its first one, like TileData::GetTilePrefabName
+TileCollision MAD::LevelLogic::GetTileCollision(const TilemapTile& _tile) const
+{
+	if (_tile.tilesetId == 0 || _tile.tilesetId >= tileCollisions.size())
+		return TILE_COLLISION_NONE;
+
+	const std::vector<TileCollision>& orientations = tileCollisions[_tile.tilesetId];
+	if (orientations.empty())
+		return TILE_COLLISION_NONE;
+
+	return orientations[_tile.orientationId < orientations.size() ? _tile.orientationId : 0];
+}
+
+bool MAD::LevelLogic::IsMergeableTile(const TilemapTile& _tile) const
+{
+	return GetTileCollision(_tile) == TILE_COLLISION_SOLID;
+}
+
+// Spawns one static collider for each rectangle of mergeable tiles
+void MAD::LevelLogic::SpawnCompoundColliders(std::shared_ptr<Tilemap> _scene, USHORT _sceneIndex)
+{
+	if (_scene == NULL)
+		return;
+
+	std::vector<TileRect> solidRects;
+	SceneStreamer::MergeSolidTiles(_scene->solidTiles, solidRects);
+
+	int tileCount = 0;
+	for (const TileRect& rect : solidRects)
+	{
+		SpawnCompoundCollider(_scene, _sceneIndex, rect);
+		tileCount += rect.width * rect.height;
 	}
+
+	if (logStats)
+		std::cout << "Scene " << _sceneIndex << " colliders: " << tileCount << " tiles merged into " << solidRects.size() << "\n";
 }
 
-std::string MAD::LevelLogic::GetTilePrefabName(EDITOR_EVENT_DATA data)
+void MAD::LevelLogic::SpawnCompoundCollider(std::shared_ptr<Tilemap> _scene, USHORT _sceneIndex, const TileRect& _rect)
 {
-	return tileData->GetTilePrefabName(data.tileset, data.orientation);
+	GMATRIXF transform = GIdentityMatrixF;
+	transform.row4.x = _scene->originX + _rect.col + (_rect.width - 1) * .5f;
+	transform.row4.y = _scene->originY + _rect.row + (_rect.height - 1) * .5f;
+
+	Tile tileInfo = { _sceneIndex, _rect.row, _rect.col };
+
+	ColliderContainer compoundColliders(false);
+	compoundColliders.AddBoxCollider(false, false, GZeroVectorF, { (float)_rect.width, (float)_rect.height, 1 });
+
+	flecsWorldLock.LockSyncWrite();
+	flecs::entity compound = flecsWorldAsync.entity()
+		.add<InScene>(GetSceneEntities(_sceneIndex).scene)
+		.add<CompoundCollider>()
+		.add<PhysicsCollidable>()
+		.set<Transform>({ transform })
+		.set<Tile>(tileInfo)
+		.add<Collidable>();
+
+	ColliderContainer colliders(compoundColliders, compound, transform.row4);
+	colliders.isTerrain = true;
+	compound.set<ColliderContainer>(std::move(colliders));
+	flecsWorldLock.UnlockSyncWrite();
+
+	GetSceneEntities(_sceneIndex).compoundColliders.push_back(compound.id());
 }
 
-std::string MAD::LevelLogic::GetTileName(EDITOR_EVENT_DATA data)
+void MAD::LevelLogic::DestroyCompoundColliders(USHORT _sceneIndex)
 {
-	return GetTileName(data.tileset, data.orientation, data.sceneIndex, data.sceneRow, data.sceneCol);
+	SceneEntities& entities = GetSceneEntities(_sceneIndex);
+
+	for (flecs::entity_t compound : entities.compoundColliders)
+		DestroyEntity(compound);
+
+	entities.compoundColliders.clear();
 }
 
-std::string MAD::LevelLogic::GetTileName(
-	USHORT _tilesetId,
-	USHORT _orientationId,
-	USHORT _sceneIndex,
-	int _sceneRow,
-	int _sceneCol)
+std::string MAD::LevelLogic::GetTilePrefabName(EDITOR_EVENT_DATA data)
 {
-	// Name format:
-	// name.plannerX.plannerY.mapX.mapY
-	std::string name = tileData->GetTilePrefabName(_tilesetId, _orientationId);
-	name += "." + std::to_string(_sceneIndex) + "." +
-		std::to_string(_sceneRow) + "." + std::to_string(_sceneCol);
-	return name;
+	return tileData->GetTilePrefabName(data.tileset, data.orientation);
 }
 
 void MAD::LevelLogic::AddCurLoadedScene(USHORT _sceneIndex)
@@ -391,6 +939,53 @@ bool MAD::LevelLogic::IsSceneLoaded(USHORT _sceneIndex)
 {
 	return std::find(curLoadedScenes.begin(), curLoadedScenes.end(), _sceneIndex) != curLoadedScenes.end();
 }
+
+// Moves the scene to the back of curLoadedScenes so it's evicted last
+void MAD::LevelLogic::TouchLoadedScene(USHORT _sceneIndex)
+{
+	auto loadedScene = std::find(curLoadedScenes.begin(), curLoadedScenes.end(), _sceneIndex);
+
+	if (loadedScene != curLoadedScenes.end())
+		std::rotate(loadedScene, loadedScene + 1, curLoadedScenes.end());
+}
+
+// The scene the player is in or entering and that scene's neighbours
+bool MAD::LevelLogic::IsSceneNeeded(USHORT _sceneIndex)
+{
+	if (_sceneIndex == curSceneIndex || _sceneIndex == nextSceneIndex)
+		return true;
+
+	std::shared_ptr<Tilemap> scene = saveLoader->GetScene(nextSceneIndex);
+	return scene != NULL &&
+		std::find(scene->neighborScenes.begin(), scene->neighborScenes.end(), _sceneIndex) != scene->neighborScenes.end();
+}
+
+// Unloads the least recently shown scenes past maxLoadedScenes, skipping needed scenes
+// and scenes with a strawberry following the player
+void MAD::LevelLogic::EvictScenes()
+{
+	if (maxLoadedScenes == 0 || curGameState == LEVEL_EDITOR)
+		return;
+
+	for (size_t i = 0; i < curLoadedScenes.size() && curLoadedScenes.size() > maxLoadedScenes;)
+	{
+		USHORT sceneIndex = curLoadedScenes[i];
+
+		bool hasFollowingTile = false;
+		followingTileQuery.each([&](Tile& _tile, FollowPlayer&)
+			{
+				hasFollowingTile |= _tile.sceneIndex == sceneIndex;
+			});
+
+		if (IsSceneNeeded(sceneIndex) || hasFollowingTile)
+		{
+			i++;
+			continue;
+		}
+
+		UnloadScene(sceneIndex);
+	}
+}
 #pragma endregion
 
 #pragma region Scenes
@@ -404,6 +999,7 @@ void MAD::LevelLogic::EnterScene(USHORT _sceneIndex, flecs::entity _sceneExit)
 	if (!CanEnterScene(_sceneIndex))
 		return;
 
+	auto enterStart = std::chrono::steady_clock::now();
 	nextSceneIndex = _sceneIndex;
 
 	ShowScene(nextSceneIndex);
@@ -414,38 +1010,52 @@ void MAD::LevelLogic::EnterScene(USHORT _sceneIndex, flecs::entity _sceneExit)
 
 	HideNonNeighborScenes(nextSceneIndex);
 
-	finishEnterScene.Create(1, [&]()
+	if (logStats)
+		std::cout << "Scene " << nextSceneIndex << " entered in "
+			<< std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - enterStart).count() << " ms\n";
+
+	timerWheel->Schedule(sceneExitTime, [this]()
 		{
 			curSceneIndex = nextSceneIndex;
 			PushLevelEvent(ENTER_SCENE_DONE, { curSceneIndex });
-			finishEnterScene.Pause(0, false);
-		}, sceneExitTime);
+		});
 }
 
+// Spawns the whole scene now, finishing it if it was streaming.
+// Every load here is a scene needed before streaming had it ready, so its time is counted as a stall.
 void MAD::LevelLogic::LoadScene(USHORT _sceneIndex)
 {
-	if (IsSceneLoaded(_sceneIndex))
+	if (IsSceneLoaded(_sceneIndex) || _sceneIndex >= saveLoader->GetAllScenes().size())
 		return;
 
-	const std::shared_ptr<Tilemap> tilemap = saveLoader->GetScene(_sceneIndex);
+	auto stallStart = std::chrono::steady_clock::now();
 
-	if (tilemap == NULL)
-		return;
+	std::shared_ptr<SceneSpawnBatch> batch;
+	if (committingBatch != nullptr && committingBatch->sceneIndex == _sceneIndex)
+		batch = std::move(committingBatch);
+	else
+		batch = sceneStreamer.Take(_sceneIndex);
 
-	for (int row = 0; row < tilemap->rows; row++)
+	// Only scenes the streamer was asked for stalled, the ones loaded without a request (Reset, the scene entered first) never streamed
+	bool wasStreaming = batch != nullptr;
+	if (batch == nullptr)
 	{
-		for (int col = 0; col < tilemap->columns; col++)
-		{
-			const TilemapTile& tile = tilemap->tiles[row][col];
-			if (tile.tilesetId == 0)
-				continue;
-
-			SpawnTile(tile, tilemap, _sceneIndex, row, col);
-		}
+		batch = std::make_shared<SceneSpawnBatch>();
+		SceneStreamer::Prepare(_sceneIndex, *saveLoader->GetScene(_sceneIndex), mergeTileColliders, *batch);
 	}
 
-	AddCurLoadedScene(_sceneIndex);
-	PushLevelEvent(LOAD_SCENE_DONE, { _sceneIndex });
+	CommitBatch(*batch, (std::chrono::steady_clock::time_point::max)());
+
+	if (!wasStreaming)
+		return;
+
+	double stallMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - stallStart).count();
+	streamStallMilliseconds += stallMilliseconds;
+	streamStalls++;
+
+	if (logStats)
+		std::cout << "Scene " << _sceneIndex << " loaded before it streamed in, stalled " << stallMilliseconds << " ms ("
+			<< streamStallMilliseconds << " ms over " << streamStalls << " stalls)\n";
 }
 
 void MAD::LevelLogic::LoadSceneNeighbors(USHORT _sceneIndex)
@@ -455,7 +1065,157 @@ void MAD::LevelLogic::LoadSceneNeighbors(USHORT _sceneIndex)
 		return;
 
 	for (int i = 0; i < scene->neighborScenes.size(); i++)
-		LoadScene(scene->neighborScenes[i]);
+		StreamScene(scene->neighborScenes[i]);
+}
+
+// Queues the scene for streaming, or updates its priority if it's already queued.
+// The scene isn't decoded here, the streamer's worker decodes it from its source.
+void MAD::LevelLogic::StreamScene(USHORT _sceneIndex)
+{
+	if (_sceneIndex >= saveLoader->GetAllScenes().size() || IsSceneLoaded(_sceneIndex))
+		return;
+
+	float priority = GetStreamPriority(_sceneIndex);
+
+	if (committingBatch != nullptr && committingBatch->sceneIndex == _sceneIndex)
+		committingBatch->priority = priority;
+	else if (sceneStreamer.IsStreaming(_sceneIndex))
+		sceneStreamer.SetPriority(_sceneIndex, priority);
+	else
+		sceneStreamer.Request(_sceneIndex, saveLoader->GetSceneSource(_sceneIndex), priority);
+}
+
+// Commits the rest of a streaming scene at once, for edits that can't wait for it
+void MAD::LevelLogic::FinishStreamingScene(USHORT _sceneIndex)
+{
+	if ((committingBatch != nullptr && committingBatch->sceneIndex == _sceneIndex) || sceneStreamer.IsStreaming(_sceneIndex))
+		LoadScene(_sceneIndex);
+}
+
+void MAD::LevelLogic::UpdateStreaming()
+{
+	UpdateStreamPriorities();
+
+	auto deadline = std::chrono::steady_clock::now() +
+		std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float, std::milli>(streamBudget));
+
+	while (std::chrono::steady_clock::now() < deadline)
+	{
+		if (committingBatch == nullptr)
+			committingBatch = sceneStreamer.PopReady();
+		if (committingBatch == nullptr)
+			break;
+
+		USHORT sceneIndex = committingBatch->sceneIndex;
+		if (!CommitBatch(*committingBatch, deadline))
+			break;
+		committingBatch.reset();
+
+		// The player may have moved on while it streamed
+		if (curGameState != LEVEL_EDITOR && !IsSceneNeeded(sceneIndex))
+			HideScene(sceneIndex);
+
+		EvictScenes();
+	}
+}
+
+// Streams the neighbours of the scene being entered, the ones the player is heading towards first
+void MAD::LevelLogic::UpdateStreamPriorities()
+{
+	std::shared_ptr<Tilemap> scene = saveLoader->GetScene(nextSceneIndex);
+	if (scene == NULL)
+		return;
+
+	for (USHORT neighborScene : scene->neighborScenes)
+		StreamScene(neighborScene);
+}
+
+// Distance from where the player will be in streamLookahead seconds to the scene's edge,
+// only the scene's bounds are read so it isn't decoded
+float MAD::LevelLogic::GetStreamPriority(USHORT _sceneIndex)
+{
+	if (_sceneIndex >= saveLoader->GetAllScenes().size() || playerQuery.count() == 0)
+		return 0;
+
+	std::shared_ptr<Tilemap> scene = saveLoader->GetAllScenes()[_sceneIndex];
+
+	flecs::entity player = playerQuery.first();
+	GVECTORF position = player.get<Transform>()->value.row4;
+
+	const Velocity* velocity = player.get<Velocity>();
+	if (velocity != nullptr)
+	{
+		position.x += velocity->value.x * streamLookahead;
+		position.y += velocity->value.y * streamLookahead;
+	}
+
+	// Tiles are centered on their cell's coordinates
+	GVECTORF minCorner = scene->GetMinCorner();
+	GVECTORF maxCorner = scene->GetMaxCorner();
+	float distanceX = max(max(minCorner.x - .5f - position.x, position.x - maxCorner.x - .5f), 0.0f);
+	float distanceY = max(max(minCorner.y - .5f - position.y, position.y - maxCorner.y - .5f), 0.0f);
+
+	return sqrt(distanceX * distanceX + distanceY * distanceY);
+}
+
+// Spawns the batch's tiles then its compound colliders until _deadline, returns true once all of it is spawned.
+// At least one spawn happens per call so a batch always makes progress. Tiles are bulk spawned a chunk at a time
+// unless the world is deferred, as it is for scenes loaded from inside other systems or observers.
+bool MAD::LevelLogic::CommitBatch(SceneSpawnBatch& _batch, std::chrono::steady_clock::time_point _deadline)
+{
+	// The scene the worker decoded replaces its archived bounds, so GetScene doesn't decode it again
+	if (_batch.scene != nullptr)
+		saveLoader->AdoptDecodedScene(_batch.sceneIndex, std::move(_batch.scene));
+
+	std::shared_ptr<Tilemap> tilemap = saveLoader->GetScene(_batch.sceneIndex);
+	if (tilemap == NULL || IsSceneLoaded(_batch.sceneIndex))
+		return true;
+
+	auto commitStart = std::chrono::steady_clock::now();
+	bool isBulkSpawning = !flecsWorld->is_deferred();
+
+	while (_batch.committedTiles < _batch.tiles.size())
+	{
+		if (isBulkSpawning)
+		{
+			size_t count = min(_batch.tiles.size() - _batch.committedTiles, TILE_SPAWN_CHUNK);
+			_batch.reusedTiles += BulkSpawnTiles(&_batch.tiles[_batch.committedTiles], count, tilemap, _batch.sceneIndex);
+			_batch.committedTiles += count;
+		}
+		else
+		{
+			const TileSpawn& spawn = _batch.tiles[_batch.committedTiles++];
+			SpawnTile(spawn.tile, tilemap, _batch.sceneIndex, spawn.row, spawn.col);
+		}
+
+		if (std::chrono::steady_clock::now() >= _deadline)
+		{
+			_batch.spawnMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - commitStart).count();
+			return false;
+		}
+	}
+
+	while (_batch.committedRects < _batch.solidRects.size())
+	{
+		SpawnCompoundCollider(tilemap, _batch.sceneIndex, _batch.solidRects[_batch.committedRects++]);
+
+		if (std::chrono::steady_clock::now() >= _deadline)
+		{
+			_batch.spawnMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - commitStart).count();
+			return false;
+		}
+	}
+
+	_batch.spawnMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - commitStart).count();
+	if (logStats)
+		std::cout << "Scene " << _batch.sceneIndex << " spawned " << _batch.tiles.size() << " tiles in " << _batch.spawnMilliseconds << " ms ("
+			<< (_batch.spawnMilliseconds > 0 ? _batch.tiles.size() / _batch.spawnMilliseconds * 1000 : 0) << " tiles/s, "
+			<< _batch.reusedTiles << " reused, " << tilePoolBytes / 1024 << " KB pooled)\n";
+
+	flecsWorld->entity(GetSceneEntities(_batch.sceneIndex).scene).set<SpawnedScene>({ _batch.sceneIndex });
+	AddCurLoadedScene(_batch.sceneIndex);
+	PushLevelEvent(LOAD_SCENE_DONE, { _batch.sceneIndex });
+	return true;
 }
 
 void MAD::LevelLogic::UnloadScene(USHORT _sceneIndex)
@@ -465,22 +1225,16 @@ void MAD::LevelLogic::UnloadScene(USHORT _sceneIndex)
 	PushLevelEvent(UNLOAD_SCENE_DONE, { _sceneIndex });
 }
 
+// Showing and hiding only moves the scene's entity, queries skip entities in a HiddenScene
 void MAD::LevelLogic::ShowScene(USHORT _sceneIndex)
 {
 	if (IsSceneLoaded(_sceneIndex))
 	{
-		tileQuery.each([&](entity _entity, Tile& _tile)
-			{
-				if (_tile.sceneIndex == _sceneIndex)
-				{
-					if (_entity.has<Strawberry>() && (_entity.has<Collected>() || _entity.has<FollowPlayer>()))
-						return;
-					if (_entity.has<ColliderContainer>())
-						_entity.add<Collidable>();
-					if (!_entity.has<RenderInEditor>() || curGameState == LEVEL_EDITOR)
-						_entity.add<RenderModel>();
-				}
-			});
+		TouchLoadedScene(_sceneIndex);
+
+		entity scene = flecsWorld->entity(GetSceneEntities(_sceneIndex).scene);
+		if (scene.has<HiddenScene>())
+			scene.remove<HiddenScene>();
 
 		PushLevelEvent(SHOW_SCENE, { _sceneIndex });
 	}
@@ -490,29 +1244,24 @@ void MAD::LevelLogic::ShowScene(USHORT _sceneIndex)
 	}
 }
 
+// Neighbours that aren't loaded yet are streamed in instead of loaded on the spot
 void MAD::LevelLogic::ShowSceneNeighbors(USHORT _sceneIndex)
 {
 	std::shared_ptr<Tilemap> scene = saveLoader->GetScene(_sceneIndex);
 	for (int i = 0; i < scene->neighborScenes.size(); i++)
 	{
-		ShowScene(scene->neighborScenes[i]);
+		if (IsSceneLoaded(scene->neighborScenes[i]))
+			ShowScene(scene->neighborScenes[i]);
+		else
+			StreamScene(scene->neighborScenes[i]);
 	}
 }
 
 void MAD::LevelLogic::HideScene(USHORT _sceneIndex)
 {
-	tileQuery.each([&](entity _entity, Tile& _tile)
-		{
-			if (_tile.sceneIndex == _sceneIndex)
-			{
-				if (_entity.has<Strawberry>() && _entity.has<FollowPlayer>())
-					return;
-				if (_entity.has<Collidable>())
-					_entity.remove<Collidable>();
-				if (_entity.has<RenderModel>())
-					_entity.remove<RenderModel>();
-			}
-		});
+	entity scene = flecsWorld->entity(GetSceneEntities(_sceneIndex).scene);
+	if (!scene.has<HiddenScene>())
+		scene.add<HiddenScene>();
 
 	PushLevelEvent(HIDE_SCENE, { _sceneIndex });
 }
@@ -536,19 +1285,19 @@ void MAD::LevelLogic::HideNonNeighborScenes(USHORT _sceneIndex)
 
 void MAD::LevelLogic::DestroyScene(USHORT _sceneIndex)
 {
-	std::vector<entity> tiles;
-	tileQuery.each([&](entity _entity, Tile& _tile)
-		{
-			if (_tile.sceneIndex == _sceneIndex)
-			{
-				tiles.push_back(_entity);
-			}
-		});
+	SceneEntities& entities = GetSceneEntities(_sceneIndex);
 
-	for (int i = 0; i < tiles.size(); i++)
-	{
-		tiles[i].destruct();
-	}
+	for (flecs::entity_t tile : entities.tiles)
+		PoolTile(tile);
+	for (flecs::entity_t compound : entities.compoundColliders)
+		DestroyEntity(compound);
+
+	DestroyEntity(entities.scene);
+
+	std::fill(entities.cells.begin(), entities.cells.end(), 0);
+	entities.tiles.clear();
+	entities.compoundColliders.clear();
+	entities.scene = 0;
 }
 #pragma endregion
 
@@ -561,8 +1310,15 @@ void MAD::LevelLogic::Reset()
 	}
 	curSceneIndex = saveLoader->GetSaveSlot().sceneIndex;
 	nextSceneIndex = saveLoader->GetSaveSlot().sceneIndex;
+	sceneStreamer.Clear();
+	committingBatch.reset();
 	curLoadedScenes.clear();
 
+	// Tiles went with the last game, their scenes' entities still hold whether they were hidden
+	for (const SceneEntities& entities : sceneEntities)
+		DestroyEntity(entities.scene);
+	sceneEntities.clear();
+
 	ShowScene(curSceneIndex);
 	ShowSceneNeighbors(curSceneIndex);
 	SpawnPlayer();
@@ -574,12 +1330,20 @@ bool LevelLogic::Shutdown()
 	flecsWorldAsync.merge();
 	flecsWorld->entity("MergeLevelStages").destruct();
 	flecsWorld->entity("Level System").destruct();
+	flecsWorld->entity("Scene Streaming System").destruct();
+
+	sceneStreamer.Stop();
+	committingBatch.reset();
+	sceneEntities.clear();
+	ClearTilePool();
 
-	tileQuery.destruct();
 	playerQuery.destruct();
+	followingTileQuery.destruct();
+	followPlayerObserver.destruct();
 
 	flecsWorld.reset();
 	gameConfig.reset();
+	timerWheel.reset();
 	return true;
 }
 
@@ -589,10 +1353,12 @@ bool LevelLogic::Activate(bool _runSystem)
 	if (_runSystem)
 	{
 		flecsWorld->entity("MergeLevelStages").enable();
+		flecsWorld->entity("Scene Streaming System").enable();
 	}
 	else
 	{
 		flecsWorld->entity("MergeLevelStages").disable();
+		flecsWorld->entity("Scene Streaming System").disable();
 	}
 
 	return false;
@@ -2,6 +2,8 @@
 #ifndef LEVELLOGIC_H
 #define LEVELLOGIC_H
 
+#include <unordered_map>
+
 #include "../GameConfig.h"
 
 #include "../Entities/PlayerData.h"
@@ -14,6 +16,9 @@
 #include "../Components/Tiles.h"
 
 #include "../Loaders/SaveLoader.h"
+#include "../Loaders/SceneStreamer.h"
+
+#include "../Utils/TimerWheel.h"
 
 #include "../Events/PlayEvents.h"
 #include "../Events/GameStateEvents.h"
@@ -42,15 +47,15 @@ namespace MAD
 		GW::CORE::GEventResponder editorEventHandler;
 		GW::CORE::GEventResponder levelEventHandler;
 
-		GW::SYSTEM::GDaemon finishEnterScene{};
-		GW::SYSTEM::GDaemon respawnPause{};
-
 		std::shared_ptr<SaveLoader> saveLoader;
+		std::shared_ptr<TimerWheel> timerWheel;
 
-		flecs::query<Tile> tileQuery;
 		flecs::query<Player> playerQuery;
+		flecs::query<Tile, FollowPlayer> followingTileQuery;
+		flecs::observer followPlayerObserver;
 
 		GAME_STATE curGameState;
+		// Least recently shown first
 		std::vector<USHORT> curLoadedScenes;
 		USHORT nextSceneIndex;
 		USHORT curSceneIndex;
@@ -60,6 +65,63 @@ namespace MAD
 		unsigned sceneExitTime;
 		unsigned respawnPauseTime;
 
+		bool mergeTileColliders;
+		bool logStats;
+		// By tilesetId then orientationId, filled once in Init so SceneStreamer's thread can read it
+		std::vector<std::vector<TileCollision>> tileCollisions;
+
+		// Entities spawned for each scene, by scene index. Kept up to date as they're spawned and destroyed
+		// so a scene's tiles are reached without walking every tile in the world.
+		struct SceneEntities
+		{
+			// Target of the scene's InScene pairs, a HiddenScene while the scene is hidden
+			flecs::entity_t scene = 0;
+			UINT32 columns = 0;
+			// rows * columns, the tile in each cell or 0
+			std::vector<flecs::entity_t> cells;
+			std::vector<flecs::entity_t> tiles;
+			std::vector<flecs::entity_t> compoundColliders;
+		};
+		std::vector<SceneEntities> sceneEntities;
+
+		// Components a tile spawns with besides its Transform and Tile
+		enum TileSpawnFlags : UCHAR
+		{
+			SPAWN_COLLIDABLE = 1 << 0,
+			SPAWN_RENDER_MODEL = 1 << 1,
+			SPAWN_IN_COMPOUND_COLLIDER = 1 << 2,
+			SPAWN_COLLECTED = 1 << 3,
+			SPAWN_STRAWBERRY = 1 << 4,
+			SPAWN_COLLIDERS = 1 << 5,
+		};
+		// Tiles bulk spawned between checks of the streaming deadline
+		static constexpr size_t TILE_SPAWN_CHUNK = 256;
+
+		// Pooling
+		// Tiles of unloaded scenes are disabled and kept by prefab instead of destroyed, so spawning a scene
+		// again mostly takes them back and rebinds their Transform, Tile and collider positions.
+		struct PooledTile
+		{
+			flecs::entity_t entity;
+			size_t bytes;
+		};
+		std::unordered_map<flecs::entity_t, std::vector<PooledTile>> tilePool;
+		size_t tilePoolBytes;
+		// Tiles past this are destroyed instead of pooled, 0 turns pooling off
+		size_t tilePoolMaxBytes;
+
+		// Streaming
+		// Neighbours of the scene being entered are prepared on the streamer's thread, nearest to where
+		// the player is heading first, and spawned a few milliseconds per frame.
+		SceneStreamer sceneStreamer;
+		std::shared_ptr<SceneSpawnBatch> committingBatch;
+		float streamBudget;
+		float streamLookahead;
+		unsigned maxLoadedScenes;
+		// Time spent loading scenes that were needed before they finished streaming
+		double streamStallMilliseconds;
+		unsigned streamStalls;
+
 	public:
 		// attach the required logic to the ECS 
 		bool Init(
@@ -70,11 +132,14 @@ namespace MAD
 			GW::CORE::GEventGenerator _levelEventPusher,
 			std::weak_ptr<const GameConfig> _gameConfig,
 			std::shared_ptr<SaveLoader> _saveLoader,
+			std::shared_ptr<TimerWheel> _timerWheel,
 			TileData* _tileData);
 
 	private:
 		void InitEventHandlers();
 		void InitMergeAsyncSystem();
+		void InitStreamingSystem();
+		void InitFollowPlayerObserver();
 
 		void OnPlayerDestroyed(PLAY_EVENT_DATA _data);
 		
@@ -95,19 +160,48 @@ namespace MAD
 			USHORT _sceneIndex, 
 			int _sceneRow, 
 			int _sceneCol);
+		size_t BulkSpawnTiles(const TileSpawn* _spawns, size_t _count, std::shared_ptr<Tilemap> _scene, USHORT _sceneIndex);
+		UCHAR GetTileSpawnFlags(const TilemapTile& _tile, USHORT _sceneIndex, flecs::entity _tilePrefab);
+		ColliderContainer GetTileColliders(const TilemapTile& _tile, flecs::entity _tilePrefab, flecs::id _ownerId, const GVECTORF& _position);
+
+		SceneEntities& GetSceneEntities(USHORT _sceneIndex);
+		void AddTileEntity(USHORT _sceneIndex, USHORT _sceneRow, USHORT _sceneCol, flecs::entity_t _entity);
+		flecs::entity_t RemoveTileEntity(USHORT _sceneIndex, USHORT _sceneRow, USHORT _sceneCol);
+		void DestroyEntity(flecs::entity_t _entity);
+
+		void PoolTile(flecs::entity_t _tile);
+		flecs::entity_t TakePooledTile(flecs::entity_t _tilePrefab);
+		void ReuseTile(flecs::entity _tile, const TilemapTile& _tileType, flecs::entity _tilePrefab, USHORT _sceneIndex, UCHAR _spawnFlags, const Tile& _tileInfo, const GMATRIXF& _transform);
+		void ClearTilePool();
+		size_t GetPooledTileBytes(flecs::entity _tile);
+
+		void BuildTileCollisions();
+		TileCollision ClassifyTilePrefab(flecs::entity _tilePrefab);
+		TileCollision GetTileCollision(const TilemapTile& _tile) const;
+		bool IsMergeableTile(const TilemapTile& _tile) const;
+		void SpawnCompoundColliders(std::shared_ptr<Tilemap> _scene, USHORT _sceneIndex);
+		void SpawnCompoundCollider(std::shared_ptr<Tilemap> _scene, USHORT _sceneIndex, const TileRect& _rect);
+		void DestroyCompoundColliders(USHORT _sceneIndex);
 
 		std::string GetTilePrefabName(EDITOR_EVENT_DATA data);
-		std::string GetTileName(EDITOR_EVENT_DATA data);
-		std::string GetTileName(USHORT _tilesetId, USHORT _orientationId, USHORT _sceneIndex, int _sceneRow, int _sceneCol);
 
 		void AddCurLoadedScene(USHORT _sceneIndex);
 		void RemoveCurLoadedScene(USHORT _sceneIndex);
 		bool IsSceneLoaded(USHORT _sceneIndex);
+		void TouchLoadedScene(USHORT _sceneIndex);
+		bool IsSceneNeeded(USHORT _sceneIndex);
+		void EvictScenes();
 
 		bool CanEnterScene(USHORT _sceneIndex);
 		void EnterScene(USHORT _sceneIndex, flecs::entity _sceneExit);
 		void LoadScene(USHORT _sceneIndex);
 		void LoadSceneNeighbors(USHORT _sceneIndex);
+		void StreamScene(USHORT _sceneIndex);
+		void FinishStreamingScene(USHORT _sceneIndex);
+		void UpdateStreaming();
+		void UpdateStreamPriorities();
+		float GetStreamPriority(USHORT _sceneIndex);
+		bool CommitBatch(SceneSpawnBatch& _batch, std::chrono::steady_clock::time_point _deadline);
 		void UnloadScene(USHORT _sceneIndex);
 		void ShowScene(USHORT _sceneIndex);
 		void ShowSceneNeighbors(USHORT _sceneIndex);
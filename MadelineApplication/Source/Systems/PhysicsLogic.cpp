@@ -16,21 +16,59 @@ using namespace CORE;
 #pragma region Init
 bool PhysicsLogic::Init(std::shared_ptr<world> _game,
 	std::weak_ptr<const GameConfig> _gameConfig,
-	GEventGenerator _levelEventPusher)
+	GEventGenerator _levelEventPusher,
+	std::shared_ptr<SaveLoader> _saveLoader)
 {
 	flecsWorld = _game;
 	gameConfig = _gameConfig;
 	levelEventPusher = _levelEventPusher;
-	
+	saveLoader = _saveLoader;
+
 	velocityQuery = flecsWorld->query<Transform, Velocity, Moveable>();
-	physicsCollidersQuery = flecsWorld->query<ColliderContainer, PhysicsCollidable, Collidable>();
-	triggerCollidersQuery = flecsWorld->query<ColliderContainer, Triggerable, Collidable>();
+	accelerationQuery = flecsWorld->query<Velocity, const Acceleration, Moveable>();
+	moveableQuery = flecsWorld->query<Transform, Moveable>();
+	physicsCollidersQuery = flecsWorld->query_builder<ColliderContainer, PhysicsCollidable, Collidable>()
+		.term<HiddenScene>().up<InScene>().not_()
+		.build();
+	triggerCollidersQuery = flecsWorld->query_builder<ColliderContainer, Triggerable, Collidable>()
+		.term<HiddenScene>().up<InScene>().not_()
+		.build();
 	tileColliderQuery = flecsWorld->query<Tile, ColliderContainer>();
 
+	std::shared_ptr<const GameConfig> readCfg = gameConfig.lock();
+	useBroadphase = readCfg->at("Physics").at("useBroadphase").as<bool>();
+	useSimdSweep = readCfg->at("Physics").at("useSimdSweep").as<bool>();
+	useTileBitmaps = readCfg->at("Physics").at("useTileBitmaps").as<bool>();
+	logStats = readCfg->at("Physics").at("logStats").as<bool>();
+	staticColliderGrid.SetCellSize(readCfg->at("Physics").at("broadphaseCellSize").as<float>());
+	movingColliderGrid.SetCellSize(staticColliderGrid.GetCellSize());
+	isStaticGridDirty = true;
+	staticColliderCount = 0;
+
+	fixedTimestep = 1.0f / readCfg->at("Physics").at("fixedStepRate").as<float>();
+	maxSubsteps = readCfg->at("Physics").at("maxSubsteps").as<int>();
+	interpolationSnapDistance = readCfg->at("Physics").at("interpolationSnapDistance").as<float>();
+	stepAccumulator = 0;
+	interpolationAlpha = 1;
+
+	triggersPerThread = readCfg->at("Physics").at("triggersPerThread").as<unsigned>();
+	workerPool.Start(readCfg->at("Physics").at("workerThreads").as<unsigned>());
+	triggerWorkerBuffers.resize(workerPool.GetThreadCount());
+	triggerJob = [this](UINT32 _begin, UINT32 _end, UINT32 _slice)
+		{
+			for (UINT32 i = _begin; i < _end; i++)
+				FindTriggerContacts(*triggerColliders[i], triggerWorkerBuffers[_slice]);
+		};
+
+	statPairTests = 0;
+	statSteps = 0;
+	statStepNanoseconds = 0;
+	statLastLogTime = GetNow();
+
 	InitEventHandlers();
-	InitAccelerationSystem();
-	InitTranslationSystem();
-	InitTriggerSystem();
+	InitBroadphaseObservers();
+	InitPhysicsSystem();
+	InitInterpolationSystem();
 
 	return true;
 }
@@ -57,123 +95,528 @@ void MAD::PhysicsLogic::InitEventHandlers()
 		});
 	levelEventPusher.Register(levelEventHandler);
 }
+
+void MAD::PhysicsLogic::InitBroadphaseObservers()
+{
+	// Tiles gain and lose Collidable as platforms crumble and strawberries are picked up,
+	// which changes what belongs in the static grid
+	collidableObserver = flecsWorld->observer<Collidable>()
+		.event(flecs::OnAdd)
+		.event(flecs::OnRemove)
+		.each([this](entity _entity, Collidable&)
+			{
+				isStaticGridDirty = true;
+			});
+
+	// Hiding or showing a scene moves only the scene's entity, its colliders leave or rejoin the queries with it
+	hiddenSceneObserver = flecsWorld->observer<HiddenScene>()
+		.event(flecs::OnAdd)
+		.event(flecs::OnRemove)
+		.each([this](entity _entity, HiddenScene&)
+			{
+				isStaticGridDirty = true;
+			});
+
+	// Terrain is only swept against scenes whose tiles are all spawned, the same ones their colliders would be
+	spawnedSceneObserver = flecsWorld->observer<SpawnedScene>()
+		.event(flecs::OnSet)
+		.event(flecs::OnRemove)
+		.each([this](flecs::iter& _it, size_t _i, SpawnedScene& _spawnedScene)
+			{
+				if (spawnedScenes.size() <= _spawnedScene.sceneIndex)
+					spawnedScenes.resize((size_t)_spawnedScene.sceneIndex + 1, 0);
+
+				spawnedScenes[_spawnedScene.sceneIndex] = _it.event() == flecs::OnSet ? _it.entity(_i).id() : 0;
+			});
+
+	// Pooled tiles are disabled instead of destroyed, which drops them from the queries without removing anything
+	disabledCollidersObserver = flecsWorld->observer<ColliderContainer>()
+		.term(flecs::Disabled)
+		.event(flecs::OnAdd)
+		.event(flecs::OnRemove)
+		.each([this](entity _entity, ColliderContainer& _colliders)
+			{
+				if (!_colliders.isMoveable)
+					isStaticGridDirty = true;
+			});
+
+	colliderContainerObserver = flecsWorld->observer<ColliderContainer>()
+		.event(flecs::OnSet)
+		.event(flecs::OnRemove)
+		.each([this](flecs::iter& _it, size_t _i, ColliderContainer& _colliders)
+			{
+				if (!_colliders.isMoveable)
+					isStaticGridDirty = true;
+
+				// The container's colliders are freed with it, so its pairs can't be resolved later
+				if (_it.event() == flecs::OnRemove)
+					contactCache.RemoveOwner(_it.entity(_i).id());
+			});
+}
 #pragma endregion
 
 #pragma region Systems
-void MAD::PhysicsLogic::InitAccelerationSystem()
+void MAD::PhysicsLogic::InitPhysicsSystem()
 {
-	flecsWorld->system<Velocity, const Acceleration, Moveable>("Acceleration System")
-		.each([](entity _entity, Velocity& _velocity, const Acceleration& _acceleration, Moveable&)
+	flecsWorld->set<ContactEvents>({});
+
+	// Physics runs in fixed steps, as many as the frame's time covers, so sweep lengths
+	// and step cost don't depend on the frame rate
+	struct PhysicsSystem {};
+	flecsWorld->entity("Physics System").add<PhysicsSystem>();
+	flecsWorld->system<PhysicsSystem>().each([this](entity _entity, PhysicsSystem& _s)
+		{
+			auto frameStart = std::chrono::steady_clock::now();
+
+			stepAccumulator += _entity.delta_time();
+
+			int substeps = 0;
+			while (stepAccumulator >= fixedTimestep && substeps < maxSubsteps)
 			{
-				GVECTORF accel;
-				GVector::ScaleF(_acceleration.value, _entity.delta_time(), accel);
-				GVector::AddVectorF(accel, _velocity.value, _velocity.value);
+				SavePreviousTransforms();
+				StepAcceleration(fixedTimestep);
+				StepTranslation(fixedTimestep);
+				StepTriggers();
+				ResolveContacts();
+
+				stepAccumulator -= fixedTimestep;
+				substeps++;
+				statSteps++;
+			}
+
+			// Drop the time we couldn't catch up on rather than carrying it into the next frames
+			if (stepAccumulator >= fixedTimestep)
+				stepAccumulator = fmod(stepAccumulator, (double)fixedTimestep);
+
+			interpolationAlpha = (float)(stepAccumulator / fixedTimestep);
+
+			LogStats(std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - frameStart).count());
+		});
+}
+
+void MAD::PhysicsLogic::InitInterpolationSystem()
+{
+	// Runs even while physics is paused, so rendering always follows the latest transforms
+	flecsWorld->system<const Transform, const PreviousTransform, InterpolatedTransform, Moveable>("Interpolation System")
+		.kind(flecs::PostUpdate)
+		.each([this](const Transform& _transform, const PreviousTransform& _previousTransform, InterpolatedTransform& _interpolatedTransform, Moveable&)
+			{
+				_interpolatedTransform.value = _transform.value;
+
+				// Large jumps are respawns and scene changes, not movement
+				if (Distance2D(_previousTransform.value.row4, _transform.value.row4) > interpolationSnapDistance)
+					return;
+
+				GVector::LerpF(
+					_previousTransform.value.row4,
+					_transform.value.row4,
+					interpolationAlpha,
+					_interpolatedTransform.value.row4);
 			});
 }
+#pragma endregion
 
-void MAD::PhysicsLogic::InitTranslationSystem()
+#pragma region Steps
+void PhysicsLogic::SavePreviousTransforms()
 {
-	struct TranslationSystem {};
-	flecsWorld->entity("Translation System").add<TranslationSystem>();
-	flecsWorld->system<TranslationSystem>().each([this](TranslationSystem& _s)
+	moveableQuery.each([](entity _entity, Transform& _transform, Moveable&)
 		{
-			physicsColliders.clear();
-			physicsCollidersQuery.each([this](entity _entity, ColliderContainer& _colliders, PhysicsCollidable&, Collidable&)
-				{
-					if (!_entity.has<Collidable>())
-						int test = 0;
-					physicsColliders.push_back(&_colliders);
-				});
+			// get_mut is deferred while systems run, so write the stored component directly
+			const PreviousTransform* previousTransform = _entity.get<PreviousTransform>();
+			if (previousTransform == nullptr)
+			{
+				_entity.set<PreviousTransform>({ _transform.value });
+				_entity.set<InterpolatedTransform>({ _transform.value });
+				return;
+			}
 
-			velocityQuery.each([this](entity _entity, Transform& _transform, Velocity& _velocity, Moveable&)
-				{
-					if (_velocity.value.x == 0 && _velocity.value.y == 0)
-						return;
-
-
-					if (_entity.has<ColliderContainer>())
-					{
-						ColliderContainer colliders = *_entity.get<ColliderContainer>();
-						HandlePhysicsCollisions(_entity, colliders, _transform, _velocity);
-
-						GVECTORF amountToMove;
-						GVector::ScaleF(_velocity.value, _entity.delta_time(), amountToMove);
-						GVector::AddVectorF(amountToMove, _transform.value.row4, _transform.value.row4);
-
-						colliders.UpdateWorldPosition(_transform.value.row4);
-						_entity.set<ColliderContainer>(colliders);
-					}
-					else
-					{
-						GVECTORF amountToMove;
-						GVector::ScaleF(_velocity.value, _entity.delta_time(), amountToMove);
-						GVector::AddVectorF(amountToMove, _transform.value.row4, _transform.value.row4);
-					}
-				});
+			const_cast<PreviousTransform*>(previousTransform)->value = _transform.value;
+		});
+}
+
+void PhysicsLogic::StepAcceleration(float _deltaTime)
+{
+	accelerationQuery.each([_deltaTime](Velocity& _velocity, const Acceleration& _acceleration, Moveable&)
+		{
+			GVECTORF accel;
+			GVector::ScaleF(_acceleration.value, _deltaTime, accel);
+			GVector::AddVectorF(accel, _velocity.value, _velocity.value);
 		});
 }
 
-void MAD::PhysicsLogic::InitTriggerSystem()
+void PhysicsLogic::StepTranslation(float _deltaTime)
 {
-	flecsWorld->system<ColliderContainer, Triggerable, Collidable>("Trigger System")
-		.each([this](entity _entity, ColliderContainer& _colliders, Triggerable&, Collidable&)
+	if (useBroadphase)
+	{
+		if (isStaticGridDirty)
+			RebuildStaticGrid();
+		BinMovingColliders(_deltaTime);
+	}
+	else
+	{
+		physicsColliders.clear();
+		physicsCollidersQuery.each([this](entity _entity, ColliderContainer& _colliders, PhysicsCollidable&, Collidable&)
 			{
-				HandleTriggerCollisions(_entity, _colliders);
+				physicsColliders.push_back(&_colliders);
 			});
+	}
+
+	velocityQuery.each([this, _deltaTime](entity _entity, Transform& _transform, Velocity& _velocity, Moveable&)
+		{
+			if (_velocity.value.x == 0 && _velocity.value.y == 0)
+				return;
+
+
+			if (_entity.has<ColliderContainer>())
+			{
+				// Updated in place, a deferred set wouldn't be visible to the next substep
+				ColliderContainer* colliders = const_cast<ColliderContainer*>(_entity.get<ColliderContainer>());
+				HandlePhysicsCollisions(_entity, *colliders, _transform, _velocity, _deltaTime);
+
+				GVECTORF amountToMove;
+				GVector::ScaleF(_velocity.value, _deltaTime, amountToMove);
+				GVector::AddVectorF(amountToMove, _transform.value.row4, _transform.value.row4);
+
+				colliders->UpdateWorldPosition(_transform.value.row4);
+			}
+			else
+			{
+				GVECTORF amountToMove;
+				GVector::ScaleF(_velocity.value, _deltaTime, amountToMove);
+				GVector::AddVectorF(amountToMove, _transform.value.row4, _transform.value.row4);
+			}
+		});
+}
+
+void PhysicsLogic::StepTriggers()
+{
+	triggerColliders.clear();
+	triggerCollidersQuery.each([this](entity _entity, ColliderContainer& _colliders, Triggerable&, Collidable&)
+		{
+			triggerColliders.push_back(&_colliders);
+		});
+
+	// Overlaps are found in parallel without writing to any container, 
+	// then applied in trigger order so the result matches a serial pass
+	workerPool.ParallelFor((UINT32)triggerColliders.size(), triggersPerThread, triggerJob);
+
+	for (TriggerWorkerBuffer& buffer : triggerWorkerBuffers)
+		ApplyTriggerContacts(buffer);
+}
+#pragma endregion
+
+#pragma region Broadphase
+void PhysicsLogic::RebuildStaticGrid()
+{
+	staticColliderGrid.Clear();
+	colliderStore.Clear();
+
+	physicsCollidersQuery.each([this](entity _entity, ColliderContainer& _colliders, PhysicsCollidable&, Collidable&)
+		{
+			if (_colliders.isMoveable)
+				return;
+
+			colliderStore.AddContainer(_colliders);
+
+			GVECTORF rangeMin, rangeMax;
+			_colliders.GetRangeBounds(rangeMin, rangeMax);
+			for (UINT32 i = _colliders.storeIndex; i < _colliders.storeIndex + _colliders.storeCount; i++)
+				staticColliderGrid.Insert(i, rangeMin.x, rangeMin.y, rangeMax.x, rangeMax.y);
+		});
+
+	staticColliderCount = colliderStore.Size();
+	isStaticGridDirty = false;
+}
+
+void PhysicsLogic::BinMovingColliders(float _deltaTime)
+{
+	movingColliderGrid.Clear();
+	colliderStore.Truncate(staticColliderCount);
+
+	physicsCollidersQuery.each([this, _deltaTime](entity _entity, ColliderContainer& _colliders, PhysicsCollidable&, Collidable&)
+		{
+			if (!_colliders.isMoveable)
+				return;
+
+			colliderStore.AddContainer(_colliders);
+
+			// Entities are moved one at a time after binning, so bin over the whole step's sweep
+			GVECTORF amountToMove = GZeroVectorF;
+			const Velocity* velocity = _entity.get<Velocity>();
+			if (velocity != nullptr && _entity.has<Moveable>())
+				amountToMove = MultiplyVector(velocity->value, _deltaTime);
+
+			GVECTORF rangeMin, rangeMax;
+			_colliders.GetRangeBounds(rangeMin, rangeMax);
+			for (UINT32 i = _colliders.storeIndex; i < _colliders.storeIndex + _colliders.storeCount; i++)
+			{
+				movingColliderGrid.Insert(
+					i,
+					min(rangeMin.x, rangeMin.x + amountToMove.x),
+					min(rangeMin.y, rangeMin.y + amountToMove.y),
+					max(rangeMax.x, rangeMax.x + amountToMove.x),
+					max(rangeMax.y, rangeMax.y + amountToMove.y));
+			}
+		});
+}
+
+void PhysicsLogic::GatherCandidates(const ColliderContainer& _colliders, const GVECTORF& _amountToMove, std::vector<UINT32>& _outIndices) const
+{
+	_outIndices.clear();
+
+	// Sweep the collision range along the movement so anything passed through is found
+	GVECTORF rangeMin, rangeMax;
+	_colliders.GetRangeBounds(rangeMin, rangeMax);
+	float minX = min(rangeMin.x, rangeMin.x + _amountToMove.x);
+	float minY = min(rangeMin.y, rangeMin.y + _amountToMove.y);
+	float maxX = max(rangeMax.x, rangeMax.x + _amountToMove.x);
+	float maxY = max(rangeMax.y, rangeMax.y + _amountToMove.y);
+
+	staticColliderGrid.Query(minX, minY, maxX, maxY, _outIndices);
+	movingColliderGrid.Query(minX, minY, maxX, maxY, _outIndices);
+}
+
+// Packs the terrain tiles under the swept collision range at the end of the store as candidates,
+// so the cost follows how far we move rather than how much terrain is loaded
+void PhysicsLogic::GatherTerrainCandidates(const ColliderContainer& _colliders, const GVECTORF& _amountToMove)
+{
+	GVECTORF rangeMin, rangeMax;
+	_colliders.GetRangeBounds(rangeMin, rangeMax);
+	float minX = min(rangeMin.x, rangeMin.x + _amountToMove.x);
+	float minY = min(rangeMin.y, rangeMin.y + _amountToMove.y);
+	float maxX = max(rangeMax.x, rangeMax.x + _amountToMove.x);
+	float maxY = max(rangeMax.y, rangeMax.y + _amountToMove.y);
+
+	// Scenes span half a tile past their outer tiles' centers, their bounds are indexed from the corner
+	terrainScenes.clear();
+	saveLoader->GetScenesInRect(minX + .5f, minY + .5f, maxX + .5f, maxY + .5f, terrainScenes);
+
+	const std::vector<std::shared_ptr<Tilemap>>& scenes = saveLoader->GetAllScenes();
+	for (USHORT sceneIndex : terrainScenes)
+	{
+		// Scenes that aren't spawned yet, were unloaded or are hidden have no colliders to stand in for
+		if (sceneIndex >= spawnedScenes.size() || spawnedScenes[sceneIndex] == 0 ||
+			flecsWorld->entity(spawnedScenes[sceneIndex]).has<HiddenScene>())
+			continue;
+
+		const std::shared_ptr<Tilemap>& scene = scenes[sceneIndex];
+
+		scene->ForEachCollisionTile(minX, minY, maxX, maxY,
+			[this, &scene](UINT32 _row, UINT32 _col, TileCollision _collision)
+			{
+				float x = (float)(scene->originX + (int)_col);
+				float y = (float)(scene->originY + (int)_row);
+
+				// One way tiles only stop landings, a flat top is enough for that
+				if (_collision == TILE_COLLISION_ONE_WAY)
+					candidateIndices.push_back(colliderStore.AddBox(x - .5f, y + .5f, x + .5f, y + .5f, COLLIDER_ONE_WAY | COLLIDER_TERRAIN));
+				else
+					candidateIndices.push_back(colliderStore.AddBox(x - .5f, y - .5f, x + .5f, y + .5f, COLLIDER_TERRAIN));
+			});
+	}
+}
+
+void PhysicsLogic::GatherCandidateContainers(const ColliderContainer& _colliders, TriggerWorkerBuffer& _buffer) const
+{
+	_buffer.candidateColliders.clear();
+	GatherCandidates(_colliders, GZeroVectorF, _buffer.candidateIndices);
+
+	// A container's colliders are packed next to each other, so sorted indices group them by owner
+	flecs::entity_t lastOwnerId = 0;
+	for (UINT32 candidateIndex : _buffer.candidateIndices)
+	{
+		// Containers none of our triggers care about are never entered
+		if (!(colliderStore.categories[candidateIndex] & _colliders.triggerMasks))
+			continue;
+
+		flecs::entity_t candidateId = colliderStore.ownerIds[candidateIndex];
+		if (candidateId == lastOwnerId || candidateId == _colliders.ownerId)
+			continue;
+		lastOwnerId = candidateId;
+
+		entity candidate = flecsWorld->entity(candidateId);
+		if (!candidate.is_alive())
+			continue;
+
+		// get_mut is deferred while systems run, the queries hand out this same storage mutably
+		const ColliderContainer* colliders = candidate.get<ColliderContainer>();
+		if (colliders != nullptr)
+			_buffer.candidateColliders.push_back(const_cast<ColliderContainer*>(colliders));
+	}
+}
+#pragma endregion
+
+#pragma region Stats
+void PhysicsLogic::LogStats(long long _stepNanoseconds)
+{
+	statStepNanoseconds += _stepNanoseconds;
+
+	if (!logStats)
+		return;
+
+	long long now = GetNow();
+	if (now - statLastLogTime < 1000)
+		return;
+
+	std::cout << "Physics (" << (useBroadphase ? "broadphase" : "all pairs") << "): "
+		<< (statSteps > 0 ? statPairTests / statSteps : 0) << " pair tests/step, "
+		<< (statSteps > 0 ? statStepNanoseconds / (long long)statSteps : 0) << " ns/step\n";
+
+	statPairTests = 0;
+	statSteps = 0;
+	statStepNanoseconds = 0;
+	statLastLogTime = now;
+}
+#pragma endregion
+
+#pragma region Contacts
+void PhysicsLogic::ResolveContacts()
+{
+	// get_mut is deferred while systems run, consumers read this same storage
+	ContactEvents* contactEvents = const_cast<ContactEvents*>(flecsWorld->get<ContactEvents>());
+	contactCache.Resolve(*contactEvents);
+
+	for (const ContactPair& pair : contactEvents->entered)
+		pair.trigger->EnterContact(pair.other);
+
+	for (const ContactPair& pair : contactEvents->exited)
+	{
+		// Only touch the trigger collider if its owner still holds it
+		entity triggerOwner = flecsWorld->entity(pair.triggerOwnerId);
+		if (!triggerOwner.is_alive())
+			continue;
+
+		const ColliderContainer* triggerColliders = triggerOwner.get<ColliderContainer>();
+		if (triggerColliders == nullptr)
+			continue;
+
+		for (const auto& triggerCol : triggerColliders->triggerColliders)
+		{
+			if (triggerCol.get() == pair.trigger)
+			{
+				pair.trigger->ExitContact(pair.other);
+				break;
+			}
+		}
+	}
+
+	for (const auto& listener : contactListeners)
+		listener(*contactEvents);
+}
+
+void PhysicsLogic::AddContactListener(std::function<void(const ContactEvents&)> _listener)
+{
+	contactListeners.push_back(std::move(_listener));
 }
 #pragma endregion
 
 #pragma region Handle Collision
-void PhysicsLogic::HandleTriggerCollisions(
-	flecs::entity _entity,
-	ColliderContainer& _colliders)
+// Only reads containers, everything it would change is written to _buffer for ApplyTriggerContacts
+void PhysicsLogic::FindTriggerContacts(
+	ColliderContainer& _colliders,
+	TriggerWorkerBuffer& _buffer) const
 {
-	for (auto otherCols : physicsColliders)
+	if (useBroadphase)
+	{
+		GatherCandidateContainers(_colliders, _buffer);
+
+		// Containers that moved out of our cells are never visited below, so exit them here.
+		// Only physics containers are entered from this side, trigger only ones track their own contacts.
+		for (int i = (int)_colliders.contacts.size() - 1; i >= 0; i--)
+		{
+			ColliderContainer* contact = _colliders.contacts[i];
+			if (contact->physicsColliders.size() == 0)
+				continue;
+			if (std::find(_buffer.candidateColliders.begin(), _buffer.candidateColliders.end(), contact) != _buffer.candidateColliders.end())
+				continue;
+
+			_buffer.contactChanges.push_back({ &_colliders, contact, false });
+		}
+	}
+
+	const std::vector<ColliderContainer*>& otherColliders = useBroadphase ? _buffer.candidateColliders : physicsColliders;
+
+	for (auto otherCols : otherColliders)
 	{
 		if (otherCols->ownerId == _colliders.ownerId)
 			continue;
+		if (!(otherCols->physicsCategories & _colliders.triggerMasks))
+			continue;
 		if (!_colliders.InCollisionRange(*otherCols))
 		{
 			if (_colliders.IsContacting(otherCols))
-			{
-				_colliders.ExitContacts(otherCols);
-				otherCols->ExitContacts(&_colliders);
-			}
+				_buffer.contactChanges.push_back({ &_colliders, otherCols, false });
 			continue;
 		}
 		else if (!_colliders.IsContacting(otherCols))
 		{
-			_colliders.EnterContacts(otherCols);
-			otherCols->EnterContacts(&_colliders);
+			_buffer.contactChanges.push_back({ &_colliders, otherCols, true });
 		}
 
-		for (auto triggerCol : _colliders.triggerColliders)
+		for (const auto& triggerCol : _colliders.triggerColliders)
 		{
-			for (auto physicsCol : otherCols->physicsColliders)
+			const GAABBMMF& triggerBox = ((const BoxCollider*)triggerCol.get())->boundBox;
+
+			for (const auto& physicsCol : otherCols->physicsColliders)
 			{
-				if (triggerCol->CollisionCheck(physicsCol.get()) == GCollision::GCollisionCheck::COLLISION)
-				{
-					if (triggerCol->IsContacting(physicsCol.get()))
-						continue;
+				if (!triggerCol->CanCollide(physicsCol.get()))
+					continue;
 
-					triggerCol->EnterContact(physicsCol.get());
-				}
-				else if (triggerCol->IsContacting(physicsCol.get()))
+				_buffer.pairTests++;
+
+				// Other containers may have moved this step, so test against their live boxes rather than the store
+				const GAABBMMF& physicsBox = ((const BoxCollider*)physicsCol.get())->boundBox;
+				if (TestBoxOverlap2D(
+					triggerBox.min.x, triggerBox.min.y, triggerBox.max.x, triggerBox.max.y,
+					physicsBox.min.x, physicsBox.min.y, physicsBox.max.x, physicsBox.max.y))
 				{
-					triggerCol->ExitContact(physicsCol.get());
+					_buffer.overlaps.push_back({ triggerCol.get(), physicsCol.get(), _colliders.ownerId, otherCols->ownerId });
 				}
 			}
 		}
 	}
+}
+
+void PhysicsLogic::ApplyTriggerContacts(TriggerWorkerBuffer& _buffer)
+{
+	for (const TriggerContactChange& change : _buffer.contactChanges)
+	{
+		if (change.isEntering)
+		{
+			change.trigger->EnterContacts(change.other);
+			change.other->EnterContacts(change.trigger);
+		}
+		else
+		{
+			change.trigger->ExitContacts(change.other);
+			change.other->ExitContacts(change.trigger);
+		}
+	}
+
+	for (const ContactPair& overlap : _buffer.overlaps)
+		contactCache.Touch(overlap.trigger, overlap.other, overlap.triggerOwnerId, overlap.otherOwnerId);
+
+	statPairTests += _buffer.pairTests;
 
+	_buffer.contactChanges.clear();
+	_buffer.overlaps.clear();
+	_buffer.pairTests = 0;
 }
 
-void PhysicsLogic::HandlePhysicsCollisions(flecs::entity _entity, const ColliderContainer& _colliders, const Transform& _transform, Velocity& _velocity)
+void PhysicsLogic::HandlePhysicsCollisions(flecs::entity _entity, ColliderContainer& _colliders, const Transform& _transform, Velocity& _velocity, float _deltaTime)
 {
-	std::vector<std::pair<float, const Collider*>> hittableColliders;
+	if (useBroadphase)
+	{
+		HandleStorePhysicsCollisions(_entity, _colliders, _velocity, _deltaTime);
+		return;
+	}
+
+	std::vector<std::pair<float, const Collider*>>& hittableColliders = hittablePhysicsColliders;
+	hittableColliders.clear();
 	RaycastHit hitResult;
 
-	GVECTORF amountToMove = MultiplyVector(_velocity.value, _entity.delta_time());
+	GVECTORF amountToMove = MultiplyVector(_velocity.value, _deltaTime);
 
 	// Fill the vector hittableColliders with all possibly hit colliders
 	for (int otherCols = 0; otherCols < physicsColliders.size(); otherCols++)
@@ -187,6 +630,11 @@ void PhysicsLogic::HandlePhysicsCollisions(flecs::entity _entity, const Collider
 		{
 			for (int otherCol = 0; otherCol < physicsColliders[otherCols]->physicsColliders.size(); otherCol++)
 			{
+				if (!_colliders.physicsColliders[curCol]->CanCollide(physicsColliders[otherCols]->physicsColliders[otherCol].get()))
+					continue;
+
+				statPairTests++;
+
 				if (_colliders.physicsColliders[curCol]->DynamicCollisionCheck2D(
 					physicsColliders[otherCols]->physicsColliders[otherCol].get(),
 					amountToMove,
@@ -216,10 +664,101 @@ void PhysicsLogic::HandlePhysicsCollisions(flecs::entity _entity, const Collider
 				hitResult) == GCollision::GCollisionCheck::COLLISION)
 			{
 				GVector::AddVectorF(_velocity.value, MultiplyVector(hitResult.surfaceNormal, AbsVector(_velocity.value)), _velocity.value);
-				amountToMove = MultiplyVector(_velocity.value, _entity.delta_time());
+				amountToMove = MultiplyVector(_velocity.value, _deltaTime);
+			}
+		}
+	}
+}
+
+// Same as HandlePhysicsCollisions, but runs over the packed colliderStore and reused buffers
+void PhysicsLogic::HandleStorePhysicsCollisions(flecs::entity _entity, ColliderContainer& _colliders, Velocity& _velocity, float _deltaTime)
+{
+	RaycastHit hitResult;
+	GVECTORF amountToMove = MultiplyVector(_velocity.value, _deltaTime);
+
+	GatherCandidates(_colliders, amountToMove, candidateIndices);
+	hittableColliders.clear();
+
+	// Pack our own colliders at the end of the store for this pass, 
+	// entities without PhysicsCollidable still collide against others
+	UINT32 storeEnd = colliderStore.Size();
+	colliderStore.AddContainer(_colliders);
+	UINT32 firstCol = _colliders.storeIndex;
+	UINT32 lastCol = _colliders.storeIndex + _colliders.storeCount;
+
+	// Drop our own colliders and any none of ours can collide with, exact per pair layers are checked below
+	candidateIndices.erase(
+		std::remove_if(candidateIndices.begin(), candidateIndices.end(),
+			[this, &_colliders](UINT32 _index) 
+			{ 
+				return colliderStore.ownerIds[_index] == _colliders.ownerId ||
+					(useTileBitmaps && (colliderStore.flags[_index] & COLLIDER_TERRAIN)) ||
+					!(colliderStore.categories[_index] & _colliders.physicsMasks) ||
+					!(colliderStore.masks[_index] & _colliders.physicsCategories);
+			}),
+		candidateIndices.end());
+
+	if (useTileBitmaps)
+		GatherTerrainCandidates(_colliders, amountToMove);
+
+	// Fill hittableColliders with all possibly hit colliders
+	for (UINT32 curCol = firstCol; curCol < lastCol; curCol++)
+	{
+		if (useSimdSweep)
+		{
+			float contactTimes[4];
+
+			for (UINT32 batch = 0; batch < candidateIndices.size(); batch += 4)
+			{
+				UINT32 batchCount = min((UINT32)candidateIndices.size() - batch, 4u);
+				statPairTests += batchCount;
+
+				int hitMask = colliderStore.DynamicCollisionCheck2D4(
+					curCol, &candidateIndices[batch], batchCount, amountToMove, contactTimes);
+
+				for (UINT32 lane = 0; lane < batchCount; lane++)
+				{
+					if (hitMask & (1 << lane) && colliderStore.CanCollide(curCol, candidateIndices[batch + lane]))
+						hittableColliders.push_back({ contactTimes[lane], candidateIndices[batch + lane] });
+				}
+			}
+			continue;
+		}
+
+		for (UINT32 otherCol : candidateIndices)
+		{
+			if (!colliderStore.CanCollide(curCol, otherCol))
+				continue;
+
+			statPairTests++;
+
+			if (colliderStore.DynamicCollisionCheck2D(curCol, otherCol, amountToMove, hitResult))
+				hittableColliders.push_back({ hitResult.contactTime, otherCol });
+		}
+	}
+
+	// sort hittable colliders by distance
+	std::sort(hittableColliders.begin(), hittableColliders.end(),
+		[](const std::pair<float, UINT32>& a, const std::pair<float, UINT32>& b)
+		{
+			return a.first < b.first;
+		});
+
+	// apply collisions in order from closest to furthest,
+	// each one changes amountToMove so the hits are swept again here
+	for (UINT32 curCol = firstCol; curCol < lastCol; curCol++)
+	{
+		for (const auto& hittableCol : hittableColliders)
+		{
+			if (colliderStore.DynamicCollisionCheck2D(curCol, hittableCol.second, amountToMove, hitResult))
+			{
+				GVector::AddVectorF(_velocity.value, MultiplyVector(hitResult.surfaceNormal, AbsVector(_velocity.value)), _velocity.value);
+				amountToMove = MultiplyVector(_velocity.value, _deltaTime);
 			}
 		}
 	}
+
+	colliderStore.Truncate(storeEnd);
 }
 #pragma endregion
 
@@ -228,15 +767,13 @@ bool PhysicsLogic::Activate(bool _runSystem)
 {
 	if (_runSystem)
 	{
-		flecsWorld->entity("Acceleration System").enable();
-		flecsWorld->entity("Translation System").enable();
-		flecsWorld->entity("Trigger System").enable();
+		flecsWorld->entity("Physics System").enable();
 	}
 	else
 	{
-		flecsWorld->entity("Acceleration System").disable();
-		flecsWorld->entity("Translation System").disable();
-		flecsWorld->entity("Trigger System").disable();
+		flecsWorld->entity("Physics System").disable();
+		// Paused transforms are shown as they are
+		interpolationAlpha = 1;
 	}
 
 	return true;
@@ -244,15 +781,26 @@ bool PhysicsLogic::Activate(bool _runSystem)
 
 bool PhysicsLogic::Shutdown()
 {
-	flecsWorld->entity("Acceleration System").destruct();
-	flecsWorld->entity("Translation System").destruct();
-	flecsWorld->entity("Trigger System").destruct();
+	flecsWorld->entity("Physics System").destruct();
+	flecsWorld->entity("Interpolation System").destruct();
+
+	workerPool.Stop();
+	contactListeners.clear();
+	spawnedScenes.clear();
 
 	velocityQuery.destruct();
+	accelerationQuery.destruct();
+	moveableQuery.destruct();
 	physicsCollidersQuery.destruct();
 	triggerCollidersQuery.destruct();
 	tileColliderQuery.destruct();
 
+	collidableObserver.destruct();
+	hiddenSceneObserver.destruct();
+	spawnedSceneObserver.destruct();
+	disabledCollidersObserver.destruct();
+	colliderContainerObserver.destruct();
+
 	flecsWorld.reset();
 	gameConfig.reset();
 
@@ -12,49 +12,161 @@
 
 #include "../Events/LevelEvents.h"
 
+#include "../Loaders/SaveLoader.h"
+
+#include "../Utils/SpatialGrid.h"
+#include "../Utils/WorkerPool.h"
+
 // example space game (avoid name collisions)
 namespace MAD
 {
 	class PhysicsLogic
 	{
+		// Container level contact found by the trigger pass, applied to both sides after it
+		struct TriggerContactChange
+		{
+			ColliderContainer* trigger;
+			ColliderContainer* other;
+			bool isEntering;
+		};
+
+		// Everything one slice of the trigger pass writes, so slices never share state
+		struct TriggerWorkerBuffer
+		{
+			std::vector<UINT32> candidateIndices;
+			std::vector<ColliderContainer*> candidateColliders;
+			std::vector<TriggerContactChange> contactChanges;
+			std::vector<ContactPair> overlaps;
+			unsigned long long pairTests = 0;
+		};
+
 	private:
 		std::shared_ptr<flecs::world> flecsWorld;
 
 		std::weak_ptr<const GameConfig> gameConfig;
+		std::shared_ptr<SaveLoader> saveLoader;
 
 		GW::CORE::GEventGenerator levelEventPusher;
 		GW::CORE::GEventResponder levelEventHandler;
 
 		flecs::query<Transform, Velocity, Moveable> velocityQuery;
+		flecs::query<Velocity, const Acceleration, Moveable> accelerationQuery;
+		flecs::query<Transform, Moveable> moveableQuery;
 		flecs::query<ColliderContainer, PhysicsCollidable, Collidable> physicsCollidersQuery;
 		flecs::query<ColliderContainer, Triggerable, Collidable> triggerCollidersQuery;
 		flecs::query<Tile, ColliderContainer> tileColliderQuery;
+
+		flecs::observer collidableObserver;
+		flecs::observer hiddenSceneObserver;
+		flecs::observer spawnedSceneObserver;
+		flecs::observer disabledCollidersObserver;
+		flecs::observer colliderContainerObserver;
 		
 		std::vector<ColliderContainer*> physicsColliders;
 		std::vector<ColliderContainer*> triggerColliders;
+		// Reused by the brute force sweep so steps don't allocate
+		std::vector<std::pair<float, const Collider*>> hittablePhysicsColliders;
+
+		// Trigger contacts, resolved into the ContactEvents singleton after every trigger pass
+		ContactPairCache contactCache;
+		// Called with the ContactEvents of every step, so no step's changes are missed when a frame runs several
+		std::vector<std::function<void(const ContactEvents&)>> contactListeners;
+
+		// Trigger pass threads, triggerColliders is split into slices with a buffer each
+		WorkerPool workerPool;
+		UINT32 triggersPerThread;
+		std::vector<TriggerWorkerBuffer> triggerWorkerBuffers;
+		std::function<void(UINT32, UINT32, UINT32)> triggerJob;
+
+		// Broadphase
+		// Static colliders are packed and binned once when the set of collidable tiles changes,
+		// moving colliders are packed after them and re-binned every step.
+		// Grids hold indices into colliderStore.
+		ColliderStore colliderStore;
+		UINT32 staticColliderCount;
+		SpatialGrid<UINT32> staticColliderGrid;
+		SpatialGrid<UINT32> movingColliderGrid;
+		std::vector<UINT32> candidateIndices;
+		std::vector<std::pair<float, UINT32>> hittableColliders;
+		bool useBroadphase;
+		bool useSimdSweep;
+		// Terrain is swept against the scenes' tile bitmaps instead of its colliders
+		bool useTileBitmaps;
+		std::vector<USHORT> terrainScenes;
+		// Scene entity of each spawned scene by scene index or 0, only their bitmaps are swept against
+		std::vector<flecs::entity_t> spawnedScenes;
+		bool isStaticGridDirty;
+
+		// Fixed timestep
+		// Frame time is banked and spent in fixed steps, the leftover fraction of a step
+		// is used to interpolate transforms for rendering.
+		float fixedTimestep;
+		int maxSubsteps;
+		float interpolationSnapDistance;
+		double stepAccumulator;
+		float interpolationAlpha;
+
+		// Stats
+		bool logStats;
+		unsigned long long statPairTests;
+		unsigned long long statSteps;
+		long long statStepNanoseconds;
+		long long statLastLogTime;
 
 	public:
 		bool Init(	std::shared_ptr<flecs::world> _game, 
 					std::weak_ptr<const GameConfig> _gameConfig,
-					GW::CORE::GEventGenerator _levelEventPusher);
+					GW::CORE::GEventGenerator _levelEventPusher,
+					std::shared_ptr<SaveLoader> _saveLoader);
 
 	private:
 		void InitEventHandlers();
+		void InitBroadphaseObservers();
 
-		void InitAccelerationSystem();
-		void InitTranslationSystem();
-		void InitTriggerSystem();
+		void InitPhysicsSystem();
+		void InitInterpolationSystem();
 
-		void HandleTriggerCollisions(
-			flecs::entity _entity,
-			ColliderContainer& _colliders);
+		void SavePreviousTransforms();
+		void StepAcceleration(float _deltaTime);
+		void StepTranslation(float _deltaTime);
+		void StepTriggers();
+
+		void RebuildStaticGrid();
+		void BinMovingColliders(float _deltaTime);
+		void GatherCandidates(
+			const ColliderContainer& _colliders,
+			const GVECTORF& _amountToMove,
+			std::vector<UINT32>& _outIndices) const;
+		void GatherTerrainCandidates(
+			const ColliderContainer& _colliders,
+			const GVECTORF& _amountToMove);
+		void GatherCandidateContainers(
+			const ColliderContainer& _colliders,
+			TriggerWorkerBuffer& _buffer) const;
+
+		void LogStats(long long _stepNanoseconds);
+
+		void ResolveContacts();
+
+		void FindTriggerContacts(
+			ColliderContainer& _colliders,
+			TriggerWorkerBuffer& _buffer) const;
+		void ApplyTriggerContacts(TriggerWorkerBuffer& _buffer);
 
 		void HandlePhysicsCollisions(
 			flecs::entity _entity,
-			const ColliderContainer& _colliders,
+			ColliderContainer& _colliders,
 			const Transform& _transform,
-			Velocity& _velocity);
+			Velocity& _velocity,
+			float _deltaTime);
+
+		void HandleStorePhysicsCollisions(
+			flecs::entity _entity,
+			ColliderContainer& _colliders,
+			Velocity& _velocity,
+			float _deltaTime);
 	public:
+		void AddContactListener(std::function<void(const ContactEvents&)> _listener);
 
 		bool Activate(bool _runSystem);
 
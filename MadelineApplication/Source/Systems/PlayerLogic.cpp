@@ -1124,8 +1124,11 @@ void PlayerLogic::HandleTriggers(ColliderContainer& _colliderContainer,
 	Acceleration& _acceleration,
 	Velocity& _velocity)
 {
+	// Enter / exit events of every step run since the last frame, in step order
+	const ContactEvents* contactEvents = &pendingContactEvents;
+
 	// ground trigger
-	UpdateGroundObjectsTouching(_colliderContainer.triggerColliders[groundTriggerId]->contacts);
+	UpdateGroundObjectsTouching(contactEvents, _colliderContainer.triggerColliders[groundTriggerId].get());
 	if (_colliderContainer.triggerColliders[groundTriggerId]->contacts.size() > 0)
 	{
 		HitGround(_acceleration, _velocity);
@@ -1136,7 +1139,7 @@ void PlayerLogic::HandleTriggers(ColliderContainer& _colliderContainer,
 	}
 
 	// right trigger
-	UpdateRightObjectsTouching(_colliderContainer.triggerColliders[rightTriggerId]->contacts);
+	UpdateRightObjectsTouching(contactEvents, _colliderContainer.triggerColliders[rightTriggerId].get());
 	if (_colliderContainer.triggerColliders[rightTriggerId]->contacts.size() > 0)
 	{
 		if (!isTouchingRightWall)
@@ -1148,7 +1151,7 @@ void PlayerLogic::HandleTriggers(ColliderContainer& _colliderContainer,
 	}
 
 	// left trigger
-	UpdateLeftObjectsTouching(_colliderContainer.triggerColliders[leftTriggerId]->contacts);
+	UpdateLeftObjectsTouching(contactEvents, _colliderContainer.triggerColliders[leftTriggerId].get());
 	if (_colliderContainer.triggerColliders[leftTriggerId]->contacts.size() > 0)
 	{
 		if (!isTouchingLeftWall)
@@ -1158,14 +1161,35 @@ void PlayerLogic::HandleTriggers(ColliderContainer& _colliderContainer,
 	{
 		LeaveWall(WallSide::LEFT, _acceleration, _velocity);
 	}
+
+	pendingContactEvents.entered.clear();
+	pendingContactEvents.exited.clear();
+}
+
+void MAD::PlayerLogic::HandleContactEvents(const ContactEvents& _contactEvents)
+{
+	for (const ContactPair& pair : _contactEvents.entered)
+	{
+		if (flecsWorld->entity(pair.triggerOwnerId).has<Player>())
+			pendingContactEvents.entered.push_back(pair);
+	}
+
+	for (const ContactPair& pair : _contactEvents.exited)
+	{
+		flecs::entity triggerOwner = flecsWorld->entity(pair.triggerOwnerId);
+		if (triggerOwner.is_alive() && triggerOwner.has<Player>())
+			pendingContactEvents.exited.push_back(pair);
+	}
+
+	pendingContactEvents.step = _contactEvents.step;
 }
 
-void MAD::PlayerLogic::UpdateGroundObjectsTouching(std::vector<Collider*>& _colliders)
+void MAD::PlayerLogic::UpdateGroundObjectsTouching(const ContactEvents* _contactEvents, Collider* _trigger)
 {
 	std::vector<flecs::id> enteredCollisions;
 	std::vector<flecs::id> exitedCollisions;
-	GetEnteredCollisions(groundObjectsTouching, _colliders, enteredCollisions);
-	GetExitedCollisions(groundObjectsTouching, _colliders, exitedCollisions);
+	GetEnteredCollisions(_contactEvents, _trigger, enteredCollisions);
+	GetExitedCollisions(_contactEvents, _trigger, exitedCollisions);
 
 	for (int i = 0; i < enteredCollisions.size(); ++i)
 		PushTouchEvent(TouchEvent::ENTER_STAND, { enteredCollisions[i] });
@@ -1173,17 +1197,17 @@ void MAD::PlayerLogic::UpdateGroundObjectsTouching(std::vector<Collider*>& _coll
 	for (int i = 0; i < exitedCollisions.size(); ++i)
 		PushTouchEvent(TouchEvent::EXIT_STAND, { exitedCollisions[i] });
 
-	UpdateObjectsTouching(groundObjectsTouching, _colliders);
+	UpdateObjectsTouching(groundObjectsTouching, _trigger->contacts);
 }
 
-void MAD::PlayerLogic::UpdateLeftObjectsTouching(std::vector<Collider*>& _colliders)
+void MAD::PlayerLogic::UpdateLeftObjectsTouching(const ContactEvents* _contactEvents, Collider* _trigger)
 {
 	if (controlState == ControlState::CLIMBING && !isClimbingRightWall)
 	{
 		std::vector<flecs::id> enteredCollisions;
 		std::vector<flecs::id> exitedCollisions;
-		GetEnteredCollisions(leftObjectsTouching, _colliders, enteredCollisions);
-		GetExitedCollisions(leftObjectsTouching, _colliders, exitedCollisions);
+		GetEnteredCollisions(_contactEvents, _trigger, enteredCollisions);
+		GetExitedCollisions(_contactEvents, _trigger, exitedCollisions);
 
 		for (int i = 0; i < enteredCollisions.size(); ++i)
 			PushTouchEvent(TouchEvent::ENTER_CLIMB, { enteredCollisions[i] });
@@ -1192,17 +1216,17 @@ void MAD::PlayerLogic::UpdateLeftObjectsTouching(std::vector<Collider*>& _collid
 			PushTouchEvent(TouchEvent::EXIT_CLIMB, { exitedCollisions[i] });
 	}
 
-	UpdateObjectsTouching(leftObjectsTouching, _colliders);
+	UpdateObjectsTouching(leftObjectsTouching, _trigger->contacts);
 }
 
-void MAD::PlayerLogic::UpdateRightObjectsTouching(std::vector<Collider*>& _colliders)
+void MAD::PlayerLogic::UpdateRightObjectsTouching(const ContactEvents* _contactEvents, Collider* _trigger)
 {
 	if (controlState == ControlState::CLIMBING && isClimbingRightWall)
 	{
 		std::vector<flecs::id> enteredCollisions;
 		std::vector<flecs::id> exitedCollisions;
-		GetEnteredCollisions(rightObjectsTouching, _colliders, enteredCollisions);
-		GetExitedCollisions(rightObjectsTouching, _colliders, exitedCollisions);
+		GetEnteredCollisions(_contactEvents, _trigger, enteredCollisions);
+		GetExitedCollisions(_contactEvents, _trigger, exitedCollisions);
 
 		for (int i = 0; i < enteredCollisions.size(); ++i)
 			PushTouchEvent(TouchEvent::ENTER_CLIMB, { enteredCollisions[i] });
@@ -1211,7 +1235,7 @@ void MAD::PlayerLogic::UpdateRightObjectsTouching(std::vector<Collider*>& _colli
 			PushTouchEvent(TouchEvent::EXIT_CLIMB, { exitedCollisions[i] });
 	}
 
-	UpdateObjectsTouching(rightObjectsTouching, _colliders);
+	UpdateObjectsTouching(rightObjectsTouching, _trigger->contacts);
 }
 
 void MAD::PlayerLogic::UpdateObjectsTouching(std::vector<flecs::id>& _touchingVector, std::vector<Collider*>& _colliders)
@@ -1232,41 +1256,27 @@ void MAD::PlayerLogic::UpdateObjectsTouching(std::vector<flecs::id>& _touchingVe
 	}
 }
 
-void MAD::PlayerLogic::GetEnteredCollisions(std::vector<flecs::id>& _touchingVector, std::vector<Collider*>& _colliders, std::vector<flecs::id>& _outIds)
+void MAD::PlayerLogic::GetEnteredCollisions(const ContactEvents* _contactEvents, const Collider* _trigger, std::vector<flecs::id>& _outIds)
 {
-	for (int i = 0; i < _colliders.size(); i++)
-	{
-		bool foundId = false;
-		for (int j = 0; j < _touchingVector.size(); j++)
-		{
-			if (_colliders[i]->ownerId == _touchingVector[j])
-			{
-				foundId = true;
-				break;
-			}
-		}
+	if (_contactEvents == nullptr)
+		return;
 
-		if (!foundId)
-			_outIds.push_back(_colliders[i]->ownerId);
+	for (const ContactPair& pair : _contactEvents->entered)
+	{
+		if (pair.trigger == _trigger)
+			_outIds.emplace_back(pair.otherOwnerId);
 	}
 }
 
-void MAD::PlayerLogic::GetExitedCollisions(std::vector<flecs::id>& _touchingVector, std::vector<Collider*>& _colliders, std::vector<flecs::id>& _outIds)
+void MAD::PlayerLogic::GetExitedCollisions(const ContactEvents* _contactEvents, const Collider* _trigger, std::vector<flecs::id>& _outIds)
 {
-	for (int i = 0; i < _touchingVector.size(); i++)
-	{
-		bool foundId = false;
-		for (int j = 0; j < _colliders.size(); j++)
-		{
-			if (_touchingVector[i] == _colliders[j]->ownerId)
-			{
-				foundId = true;
-				break;
-			}
-		}
+	if (_contactEvents == nullptr)
+		return;
 
-		if (!foundId)
-			_outIds.push_back(_touchingVector[i]);
+	for (const ContactPair& pair : _contactEvents->exited)
+	{
+		if (pair.trigger == _trigger)
+			_outIds.emplace_back(pair.otherOwnerId);
 	}
 }
 #pragma endregion
@@ -1373,6 +1383,8 @@ void MAD::PlayerLogic::GameplayStop()
 	groundObjectsTouching.clear();
 	rightObjectsTouching.clear();
 	leftObjectsTouching.clear();
+	pendingContactEvents.entered.clear();
+	pendingContactEvents.exited.clear();
 }
 
 bool PlayerLogic::Activate(bool _runSystem)
@@ -161,6 +161,9 @@ namespace MAD
 		std::vector<flecs::id> groundObjectsTouching;
 		std::vector<flecs::id> leftObjectsTouching;
 		std::vector<flecs::id> rightObjectsTouching;
+		// Enter / exit events of the player's triggers from every physics step since HandleTriggers last ran,
+		// a frame can run several steps and each one replaces the ContactEvents singleton
+		ContactEvents pendingContactEvents;
 
 		// Death
 		UINT8 killPlayer : 1;
@@ -196,6 +199,9 @@ namespace MAD
 			std::shared_ptr<SaveLoader> _saveLoader);
 #pragma endregion
 
+		// Queues the contact changes of the player's triggers for HandleTriggers, called by the physics step
+		void HandleContactEvents(const ContactEvents& _contactEvents);
+
 	private:
 #pragma region INI
 		void LoadINIStats();
@@ -326,17 +332,17 @@ namespace MAD
 			Acceleration& _acceleration,
 			Velocity& _velocity);
 
-		void UpdateGroundObjectsTouching(std::vector<Collider*>& _colliders);
-		void UpdateLeftObjectsTouching(std::vector<Collider*>& _colliders);
-		void UpdateRightObjectsTouching(std::vector<Collider*>& _colliders);
+		void UpdateGroundObjectsTouching(const ContactEvents* _contactEvents, Collider* _trigger);
+		void UpdateLeftObjectsTouching(const ContactEvents* _contactEvents, Collider* _trigger);
+		void UpdateRightObjectsTouching(const ContactEvents* _contactEvents, Collider* _trigger);
 		void UpdateObjectsTouching(std::vector<flecs::id>& _touchingVector, std::vector<Collider*>& _colliders);
 		void GetEnteredCollisions(
-			std::vector<flecs::id>& _touchingVector, 
-			std::vector<Collider*>& _colliders, 
+			const ContactEvents* _contactEvents,
+			const Collider* _trigger,
 			std::vector<flecs::id>& _outIds);
 		void GetExitedCollisions(
-			std::vector<flecs::id>& _touchingVector,
-			std::vector<Collider*>& _colliders,
+			const ContactEvents* _contactEvents,
+			const Collider* _trigger,
 			std::vector<flecs::id>& _outIds);
 #pragma endregion
 
@@ -119,7 +119,10 @@ bool MAD::DirectX11Renderer::Init(GW::SYSTEM::GWindow _win,
 
 	modelQuery = flecsWorld->query<const RenderModel, const ModelIndex, const Moveable>();
 	animationQuery = flecsWorld->query<const RenderModel, const AnimateModel, const Moveable, const ModelIndex>();
-	levelQuery = flecsWorld->query<const RenderModel, const ModelIndex, const StaticModel>();
+	// Must match updateDrawStatic's entities and order, the two are drawn together by index
+	levelQuery = flecsWorld->query_builder<const RenderModel, const ModelIndex, const StaticModel>()
+		.term<HiddenScene>().up<InScene>().not_()
+		.build();
 	spriteQuery = uiWorld->query<const RenderSprite, Sprite>();
 	textQuery = uiWorld->query<const RenderText, Text>();
 
@@ -902,11 +905,13 @@ void MAD::DirectX11Renderer::InitRendererSystems()
 
 
 	updateDrawMoveable = flecsWorld->system<MAD::Transform, MAD::ModelIndex, MAD::ModelOffset, MAD::RenderModel, MAD::Moveable>().kind(flecs::OnUpdate)
-		.each([this](MAD::Transform& pos, MAD::ModelIndex& ndx, MAD::ModelOffset& offset, MAD::RenderModel&, MAD::Moveable&)
+		.each([this](flecs::entity _entity, MAD::Transform& pos, MAD::ModelIndex& ndx, MAD::ModelOffset& offset, MAD::RenderModel&, MAD::Moveable&)
 			{
 				int i = drawCounter;
 
-				instanceTransforms.transforms[i] = pos.value;
+				// draw between physics steps when the entity has been stepped
+				const MAD::InterpolatedTransform* interpolated = _entity.get<MAD::InterpolatedTransform>();
+				instanceTransforms.transforms[i] = interpolated ? interpolated->value : pos.value;
 				GW::MATH::GVector::AddVectorF(instanceTransforms.transforms[i].row4, offset.value, instanceTransforms.transforms[i].row4);
 
 				// increment the shared draw counter but don't go over (branchless) 
@@ -919,6 +924,7 @@ void MAD::DirectX11Renderer::InitRendererSystems()
 			});
 
 	updateDrawStatic = flecsWorld->system<MAD::Transform, MAD::ModelIndex, MAD::ModelOffset, MAD::RenderModel, MAD::StaticModel>().kind(flecs::OnUpdate)
+		.term<MAD::HiddenScene>().up<MAD::InScene>().not_()
 		.each([this](MAD::Transform& pos, MAD::ModelIndex& ndx, MAD::ModelOffset& offset, MAD::RenderModel&, MAD::StaticModel&)
 			{
 				int i = drawCounter;
@@ -1268,7 +1274,7 @@ void MAD::DirectX11Renderer::UpdateAnimations(unsigned modelNdx, float deltaTime
 		}
 		else
 		{
-			if (modelLoader->models[modelNdx].model->HasAnimations())
+			if (modelLoader->models[modelNdx].HasAnimations())
 				modelLoader->models[modelNdx].UpdatePose(modelElapsedTime, animationState.currentAnimNDX);
 		}
 	}
@@ -1276,7 +1282,7 @@ void MAD::DirectX11Renderer::UpdateAnimations(unsigned modelNdx, float deltaTime
 
 void MAD::DirectX11Renderer::UpdateAnimationsBlended(unsigned modelNdx, float _modelElapsedTime, float transitionTime)
 {
-	if (modelLoader->models[modelNdx].model->HasAnimations())
+	if (modelLoader->models[modelNdx].HasAnimations())
 		modelLoader->models[modelNdx].UpdatePoseBlended(_modelElapsedTime, animationState.currentAnimNDX, animationState.nextAnimNdx, transitionTime);
 
 	if (animationState.transitionTimer >= transitionLength)
@@ -8,7 +8,8 @@ bool MAD::TileLogic::Init(
 	GW::CORE::GEventGenerator _levelEventPusher,
 	GW::CORE::GEventGenerator _gameStateEventPusher,
 	GW::CORE::GEventGenerator _touchEventPusher,
-	std::shared_ptr<SaveLoader> _saveLoader)
+	std::shared_ptr<SaveLoader> _saveLoader,
+	std::shared_ptr<TimerWheel> _timerWheel)
 {
 	flecsWorld = _flecsWorld;
 	gameConfig = _gameConfig;
@@ -17,6 +18,7 @@ bool MAD::TileLogic::Init(
 	gameStateEventPusher = _gameStateEventPusher;
 	touchEventPusher = _touchEventPusher;
 	saveLoader = _saveLoader;
+	timerWheel = _timerWheel;
 
 	followingStrawberriesQuery = flecsWorld->query<Strawberry, FollowPlayer>();
 	playerQuery = flecsWorld->query<Player, Moveable>();
@@ -29,13 +31,7 @@ bool MAD::TileLogic::Init(
 	crumblingPlatformRespawnTime = readCfg->at("CrumblingPlatform").at("respawnTime").as<unsigned>();
 
 	InitEventHandlers();
-	InitSpringSystem();
-	InitCrystalSystems();
-	InitSpikeSystem();
 	InitStrawberrySystem();
-	InitGraveSystem();
-	InitSceneExitSystem();
-	InitCrumblingPlatformSystems();
 
 	return true;
 }
@@ -110,179 +106,48 @@ void MAD::TileLogic::InitEventHandlers()
 			}
 		});
 	touchEventPusher.Register(touchEventHandler);
-}
 
-#pragma region Systems
-void MAD::TileLogic::InitSpringSystem()
-{
-	springSystem = flecsWorld->system<Spring, ColliderContainer>()
-		.each([this](Spring&, const ColliderContainer& _colliderContainer) {
-		for (auto collider : _colliderContainer.colliders)
+	levelEventHandler.Create([this](const GW::GEvent& _event)
 		{
-			for (auto contact : collider->contacts)
-			{
-				if (flecsWorld->entity(ecs_get_name(*flecsWorld, contact->ownerId)).has<Player>())
-				{
-					PushPlayEvent(PlayEvent::HIT_SPRING);
-				}
-			}
-		}
-			});
-}
+			LEVEL_EVENT event;
+			LEVEL_EVENT_DATA data;
 
-void MAD::TileLogic::InitCrystalSystems()
-{
-	crystalCollectSystem = flecsWorld->system<Crystal, ColliderContainer, Collidable>()
-		.each([this](flecs::entity _entity, Crystal&, const ColliderContainer& _colliderContainer, Collidable& _collidable) {
-		for (auto collider : _colliderContainer.colliders)
-		{
-			if (_entity.has<Collected>())
+			if (-_event.Read(event, data))
 				return;
 
-			for (auto contact : collider->contacts)
+			switch (event)
 			{
-				if (flecsWorld->entity(ecs_get_name(*flecsWorld, contact->ownerId)).has<Player>())
-				{
-					PushPlayEvent(PlayEvent::HIT_CRYSTAL, { _entity });
-				}
-			}
-		}
-			});
-
-	crystalRespawnSystem = flecsWorld->system<Crystal, Collected, TimeCollected>()
-		.each([this](flecs::entity _entity, Crystal&, Collected&, TimeCollected& _timeCollected)
+			case ENTER_SCENE_DONE:
 			{
-				auto now = GetNow();
-				if (now - _timeCollected.value > crystalRespawnTime)
-				{
-					_entity.add<RenderModel>();
-					_entity.add<Collidable>();
-					_entity.remove<Collected>();
-				}
-			});
-}
-
-void MAD::TileLogic::InitSpikeSystem()
-{
-	spikeSystem = flecsWorld->system<Spikes, ColliderContainer>()
-		.each([this](flecs::entity _entity, Spikes&, const ColliderContainer& _colliderContainer) {
-		for (auto collider : _colliderContainer.colliders)
-		{
-			for (auto contact : collider->contacts)
+				OnEnterSceneDone(data);
+				break;
+			}
+			default:
 			{
-				if (flecsWorld->entity(ecs_get_name(*flecsWorld, contact->ownerId)).has<Player>())
-				{
-					PushPlayEvent(PlayEvent::HIT_SPIKES);
-				}
+				break;
 			}
-		}
-			});
+			}
+		});
+	levelEventPusher.Register(levelEventHandler);
 }
 
+#pragma region Systems
 void MAD::TileLogic::InitStrawberrySystem()
 {
-	strawberrySystem = flecsWorld->system<Strawberry, Transform, ColliderContainer, Tile>()
-		.each([this](flecs::entity _entity, Strawberry&, Transform& _transform, const ColliderContainer& _colliderContainer, const Tile& _tile)
+	strawberryFollowSystem = flecsWorld->system<Strawberry, FollowPlayer, Transform>()
+		.each([this](flecs::entity _entity, Strawberry&, FollowPlayer&, Transform& _transform)
 			{
-				if (_entity.has<Collected>())
+				if (playerQuery.count() == 0)
 					return;
 
-				for (auto collider : _colliderContainer.colliders)
+				GMATRIXF playerTransform = playerQuery.first().get<Transform>()->value;
+				if (Distance2D(playerTransform.row4, _transform.value.row4) > strawberryFollowDist)
 				{
-					for (auto contact : collider->contacts)
-					{
-						if (flecsWorld->entity(ecs_get_name(*flecsWorld, contact->ownerId)).has<Player>())
-						{
-							PLAY_EVENT_DATA eventData{};
-							eventData.value = _tile.sceneIndex;
-							PushPlayEvent(PlayEvent::HIT_STRAWBERRY, eventData);
-							_entity.add<FollowPlayer>();
-							_entity.remove<Collidable>();
-							auto colliderContainer = *_entity.get<ColliderContainer>();
-							colliderContainer.DropAllContacts();
-							_entity.set<ColliderContainer>(colliderContainer);
-						}
-					}
-				}
-
-				if (_entity.has<FollowPlayer>() && playerQuery.count() > 0)
-				{
-					GMATRIXF playerTransform = playerQuery.first().get<Transform>()->value;
-					if (Distance2D(playerTransform.row4, _transform.value.row4) > strawberryFollowDist)
-					{
-						GVector::LerpF(
-							_transform.value.row4,
-							playerTransform.row4,
-							strawberryFollowSmoothing * _entity.delta_time(),
-							_transform.value.row4);
-					}
-				}
-			});
-}
-
-void MAD::TileLogic::InitGraveSystem()
-{
-	graveSystem = flecsWorld->system<Grave, ColliderContainer>()
-		.each([this](Grave&, const ColliderContainer& _colliderContainer) {
-		for (auto collider : _colliderContainer.colliders)
-		{
-			for (auto contact : collider->contacts)
-			{
-				if (flecsWorld->entity(ecs_get_name(*flecsWorld, contact->ownerId)).has<Player>())
-				{
-					PushPlayEvent(PlayEvent::HIT_GRAVE);
-				}
-			}
-		}
-			});
-}
-
-void MAD::TileLogic::InitSceneExitSystem()
-{
-	sceneExitSystem = flecsWorld->system<SceneExit, Tile, ColliderContainer, Collidable>()
-		.each([this](flecs::entity _entity, SceneExit&, Tile& _tile, ColliderContainer& _colliderContainer, Collidable&)
-			{
-				for (auto collider : _colliderContainer.colliders)
-				{
-					for (auto contact : collider->contacts)
-					{
-						if (flecsWorld->entity(ecs_get_name(*flecsWorld, contact->ownerId)).has<Player>())
-						{
-							PushLevelEvent(HIT_SCENE_EXIT, { saveLoader->GetScene(_tile.sceneIndex)->GetTile(_tile)->orientationId, _entity });
-						}
-					}
-				}
-			});
-}
-
-void MAD::TileLogic::InitCrumblingPlatformSystems()
-{
-	crumblingPlatformCrumbleSystem = flecsWorld->system<CrumblingPlatform, Touched, TimeTouched>()
-		.each([this](flecs::entity _entity, CrumblingPlatform&, Touched&, TimeTouched& _timeTouched)
-			{
-				auto now = GetNow();
-				if (now - _timeTouched.value > crumblingPlatformCrumbleTime)
-				{
-					_entity.remove<Touched>();
-					_entity.remove<RenderModel>();
-					_entity.remove<Collidable>();
-					auto colliderContainer = *_entity.get<ColliderContainer>();
-					colliderContainer.DropAllContacts();
-					_entity.set<ColliderContainer>(colliderContainer);
-					_entity.add<Crumbled>();
-					_entity.set<TimeCrumbled>({ GetNow() });
-				}
-			});
-
-	crumblingPlatformRespawnSystem = flecsWorld->system<CrumblingPlatform, Crumbled, TimeCrumbled>()
-		.each([this](flecs::entity _entity, CrumblingPlatform&, Crumbled&, TimeCrumbled& _timeCrumbled)
-			{
-				auto now = GetNow();
-				if (now - _timeCrumbled.value > crumblingPlatformRespawnTime)
-				{
-					_entity.add<RenderModel>();
-					_entity.add<Collidable>();
-					_entity.remove<Crumbled>();
+					GVector::LerpF(
+						_transform.value.row4,
+						playerTransform.row4,
+						strawberryFollowSmoothing * _entity.delta_time(),
+						_transform.value.row4);
 				}
 			});
 }
@@ -311,9 +176,165 @@ void MAD::TileLogic::PushGameStateEvent(GAME_STATE _event, GAME_STATE_EVENT_DATA
 }
 #pragma endregion
 
+#pragma region Contacts
+// Drops contacts on the container flecs stores, a copy would unhook the wrong address from its contacts
+void MAD::TileLogic::DropAllContacts(flecs::entity _entity)
+{
+	const ColliderContainer* colliderContainer = _entity.get<ColliderContainer>();
+	if (colliderContainer == nullptr)
+		return;
+
+	const_cast<ColliderContainer*>(colliderContainer)->DropAllContacts();
+}
+
+// Keeps the handle on the tile so LevelLogic can cancel it when the tile is pooled
+void MAD::TileLogic::SetTileTimer(flecs::entity _entity, TileTimer _timer, TimerWheel::Handle _handle)
+{
+	TileTimers timers = {};
+	const TileTimers* currentTimers = _entity.get<TileTimers>();
+	if (currentTimers != nullptr)
+		timers = *currentTimers;
+
+	timers.handles[_timer] = _handle;
+	_entity.set<TileTimers>(timers);
+}
+
+// Only the contact changes of the step are walked, tile triggers are masked to the Player category
+// so almost every pair here is the player entering or leaving a tile
+void MAD::TileLogic::HandleContactEvents(const ContactEvents& _contactEvents)
+{
+	if (!isHandlingContacts)
+		return;
+
+	for (const ContactPair& pair : _contactEvents.entered)
+	{
+		if (flecsWorld->entity(pair.otherOwnerId).has<Player>())
+			OnPlayerEnterTile(flecsWorld->entity(pair.triggerOwnerId));
+	}
+
+	for (const ContactPair& pair : _contactEvents.exited)
+	{
+		flecs::entity tile = flecsWorld->entity(pair.triggerOwnerId);
+		if (tile.is_alive() && flecsWorld->entity(pair.otherOwnerId).has<Player>())
+			OnPlayerExitTile(tile);
+	}
+
+	for (size_t i = 0; i < touchingCrystals.size();)
+	{
+		flecs::entity crystal = flecsWorld->entity(touchingCrystals[i]);
+		if (!crystal.is_alive())
+		{
+			touchingCrystals.erase(touchingCrystals.begin() + i);
+			continue;
+		}
+
+		OnPlayerTouchCrystal(crystal);
+		i++;
+	}
+
+	for (size_t i = 0; i < touchingSpikes.size();)
+	{
+		flecs::entity spikes = flecsWorld->entity(touchingSpikes[i]);
+		if (!spikes.is_alive())
+		{
+			touchingSpikes.erase(touchingSpikes.begin() + i);
+			continue;
+		}
+
+		OnPlayerTouchSpikes(spikes);
+		i++;
+	}
+}
+#pragma endregion
+
+#pragma region Tile Reactions
+void MAD::TileLogic::OnPlayerEnterTile(flecs::entity _tile)
+{
+	if (_tile.has<Spring>())
+		OnPlayerEnterSpring(_tile);
+	else if (_tile.has<Crystal>())
+		touchingCrystals.push_back(_tile.id());
+	else if (_tile.has<Spikes>())
+		touchingSpikes.push_back(_tile.id());
+	else if (_tile.has<Strawberry>())
+		OnPlayerEnterStrawberry(_tile);
+	else if (_tile.has<Grave>())
+		OnPlayerEnterGrave(_tile);
+	else if (_tile.has<SceneExit>())
+	{
+		touchingSceneExits.push_back(_tile.id());
+		OnPlayerEnterSceneExit(_tile);
+	}
+}
+
+void MAD::TileLogic::OnPlayerExitTile(flecs::entity _tile)
+{
+	if (_tile.has<Crystal>())
+		touchingCrystals.erase(
+			std::remove(touchingCrystals.begin(), touchingCrystals.end(), _tile.id()),
+			touchingCrystals.end());
+	else if (_tile.has<Spikes>())
+		touchingSpikes.erase(
+			std::remove(touchingSpikes.begin(), touchingSpikes.end(), _tile.id()),
+			touchingSpikes.end());
+	else if (_tile.has<SceneExit>())
+		touchingSceneExits.erase(
+			std::remove(touchingSceneExits.begin(), touchingSceneExits.end(), _tile.id()),
+			touchingSceneExits.end());
+}
+
+void MAD::TileLogic::OnPlayerEnterSpring(flecs::entity _tile)
+{
+	PushPlayEvent(PlayEvent::HIT_SPRING);
+}
+
+// The player only takes a crystal when it can replenish its stats, so this runs every step it stays inside
+void MAD::TileLogic::OnPlayerTouchCrystal(flecs::entity _tile)
+{
+	if (_tile.has<Collected>() || !_tile.has<Collidable>())
+		return;
+
+	PushPlayEvent(PlayEvent::HIT_CRYSTAL, { _tile });
+}
+
+// Spikes kill every step the player overlaps them, not just on entering
+void MAD::TileLogic::OnPlayerTouchSpikes(flecs::entity _tile)
+{
+	PushPlayEvent(PlayEvent::HIT_SPIKES);
+}
+
+void MAD::TileLogic::OnPlayerEnterStrawberry(flecs::entity _tile)
+{
+	if (_tile.has<Collected>() || _tile.has<FollowPlayer>())
+		return;
+
+	PLAY_EVENT_DATA eventData{};
+	eventData.value = _tile.get<Tile>()->sceneIndex;
+	PushPlayEvent(PlayEvent::HIT_STRAWBERRY, eventData);
+	_tile.add<FollowPlayer>();
+	_tile.remove<Collidable>();
+	DropAllContacts(_tile);
+}
+
+void MAD::TileLogic::OnPlayerEnterGrave(flecs::entity _tile)
+{
+	PushPlayEvent(PlayEvent::HIT_GRAVE);
+}
+
+void MAD::TileLogic::OnPlayerEnterSceneExit(flecs::entity _tile)
+{
+	const Tile* tile = _tile.get<Tile>();
+	PushLevelEvent(HIT_SCENE_EXIT, { saveLoader->GetScene(tile->sceneIndex)->GetTile(*tile)->orientationId, _tile });
+}
+#pragma endregion
+
 #pragma region Play Events
 void MAD::TileLogic::OnPlayerDestroyed(PLAY_EVENT_DATA _data)
 {
+	touchingCrystals.clear();
+	touchingSpikes.clear();
+	touchingSceneExits.clear();
+
 	flecsWorld->defer_begin();
 	followingStrawberriesQuery.each([this](flecs::entity _entity, Strawberry&, FollowPlayer&)
 		{
@@ -343,29 +364,81 @@ void MAD::TileLogic::OnCollectCrystal(PLAY_EVENT_DATA _data)
 {
 	flecsWorld->defer_begin();
 
-	flecs::entity _entity = flecsWorld->entity(ecs_get_name(*flecsWorld, _data.entityId));
+	flecs::entity _entity = flecsWorld->entity(_data.entityId);
 	_entity.remove<RenderModel>();
 	_entity.remove<Collidable>();
 	_entity.add<Collected>();
-	_entity.set<TimeCollected>({ GetNow() });
-	auto colliderContainer = *_entity.get<ColliderContainer>();
-	colliderContainer.DropAllContacts();
-	_entity.set<ColliderContainer>(colliderContainer);
+	DropAllContacts(_entity);
+
+	SetTileTimer(_entity, RESPAWN_TIMER, timerWheel->Schedule(crystalRespawnTime, [_entity]() mutable
+		{
+			if (!_entity.is_alive())
+				return;
+
+			_entity.add<RenderModel>();
+			_entity.add<Collidable>();
+			_entity.remove<Collected>();
+		}));
 
 	flecsWorld->defer_end();
 }
 #pragma endregion
 
+#pragma region Level Events
+// Scene exits are only hit on entering them, and LevelLogic turns hits away while the last transition runs
+void MAD::TileLogic::OnEnterSceneDone(LEVEL_EVENT_DATA _data)
+{
+	if (!isHandlingContacts)
+		return;
+
+	for (size_t i = 0; i < touchingSceneExits.size();)
+	{
+		flecs::entity sceneExit = flecsWorld->entity(touchingSceneExits[i]);
+		if (!sceneExit.is_alive())
+		{
+			touchingSceneExits.erase(touchingSceneExits.begin() + i);
+			continue;
+		}
+
+		OnPlayerEnterSceneExit(sceneExit);
+		i++;
+	}
+}
+#pragma endregion
+
 #pragma region Touch Events
+void MAD::TileLogic::CrumblePlatform(flecs::entity _entity)
+{
+	_entity.remove<Touched>();
+	_entity.remove<RenderModel>();
+	_entity.remove<Collidable>();
+	DropAllContacts(_entity);
+	_entity.add<Crumbled>();
+
+	SetTileTimer(_entity, RESPAWN_TIMER, timerWheel->Schedule(crumblingPlatformRespawnTime, [_entity]() mutable
+		{
+			if (!_entity.is_alive())
+				return;
+
+			_entity.add<RenderModel>();
+			_entity.add<Collidable>();
+			_entity.remove<Crumbled>();
+		}));
+}
+
 void MAD::TileLogic::OnEnterTouch(TouchEventData _data)
 {
 	flecsWorld->defer_begin();
 
-	flecs::entity _entity = flecsWorld->entity(ecs_get_name(*flecsWorld, _data.entityId));
+	flecs::entity _entity = flecsWorld->entity(_data.entityId);
 	if (_entity.has<CrumblingPlatform>() && !_entity.has<Touched>())
 	{
 		_entity.add<Touched>();
-		_entity.set_override<TimeTouched>({ GetNow() });
+		SetTileTimer(_entity, CRUMBLE_TIMER, timerWheel->Schedule(crumblingPlatformCrumbleTime, [this, _entity]()
+			{
+				if (_entity.is_alive() && _entity.has<Touched>())
+					CrumblePlatform(_entity);
+			}));
 	}
 
 	flecsWorld->defer_end();
@@ -375,17 +448,14 @@ void MAD::TileLogic::OnExitTouch(TouchEventData _data)
 {
 	flecsWorld->defer_begin();
 
-	flecs::entity _entity = flecsWorld->entity(ecs_get_name(*flecsWorld, _data.entityId));
+	flecs::entity _entity = flecsWorld->entity(_data.entityId);
 	if (_entity.has<CrumblingPlatform>() && !_entity.has<Crumbled>())
 	{
-		_entity.remove<Touched>();
-		_entity.remove<RenderModel>();
-		_entity.remove<Collidable>();
-		auto colliderContainer = *_entity.get<ColliderContainer>();
-		colliderContainer.DropAllContacts();
-		_entity.set<ColliderContainer>(colliderContainer);
-		_entity.add<Crumbled>();
-		_entity.set_override<TimeCrumbled>({ GetNow() });
+		const TileTimers* timers = _entity.get<TileTimers>();
+		if (timers != nullptr)
+			timerWheel->Cancel(timers->handles[CRUMBLE_TIMER]);
+
+		CrumblePlatform(_entity);
 	}
 
 	flecsWorld->defer_end();
@@ -396,27 +466,15 @@ void MAD::TileLogic::OnExitTouch(TouchEventData _data)
 #pragma region Activate / Shutdown
 bool MAD::TileLogic::Activate(bool _runSystem)
 {
+	isHandlingContacts = _runSystem;
+
 	if (_runSystem)
 	{
-		springSystem.enable();
-		strawberrySystem.enable();
-		crystalCollectSystem.enable();
-		crystalRespawnSystem.enable();
-		graveSystem.enable();
-		sceneExitSystem.enable();
-		crumblingPlatformCrumbleSystem.enable();
-		crumblingPlatformRespawnSystem.enable();
+		strawberryFollowSystem.enable();
 	}
 	else
 	{
-		springSystem.disable();
-		strawberrySystem.disable();
-		crystalCollectSystem.disable();
-		crystalRespawnSystem.disable();
-		graveSystem.disable();
-		sceneExitSystem.disable();
-		crumblingPlatformCrumbleSystem.disable();
-		crumblingPlatformRespawnSystem.disable();
+		strawberryFollowSystem.disable();
 	}
 
 	return true;
@@ -424,20 +482,19 @@ bool MAD::TileLogic::Activate(bool _runSystem)
 
 bool MAD::TileLogic::Shutdown()
 {
-	springSystem.destruct();
-	strawberrySystem.destruct();
-	crystalCollectSystem.destruct();
-	graveSystem.destruct();
-	sceneExitSystem.destruct();
-	crumblingPlatformCrumbleSystem.destruct();
-	crumblingPlatformRespawnSystem.destruct();
+	strawberryFollowSystem.destruct();
 
 	followingStrawberriesQuery.destruct();
 	playerQuery.destruct();
 
+	touchingCrystals.clear();
+	touchingSpikes.clear();
+	touchingSceneExits.clear();
+
 	flecsWorld.reset();
 	gameConfig.reset();
 	saveLoader.reset();
+	timerWheel.reset();
 
 	return true;
 }
@@ -5,6 +5,8 @@
 
 #include "../Loaders/SaveLoader.h"
 
+#include "../Utils/TimerWheel.h"
+
 #include "../Components/Identification.h"
 #include "../Components/Physics.h"
 #include "../Components/Visuals.h"
@@ -27,23 +29,15 @@ namespace MAD
 		GW::CORE::GEventGenerator touchEventPusher;
 		GW::CORE::GEventResponder playEventHandler;
 		GW::CORE::GEventResponder touchEventHandler;
-
-		GW::SYSTEM::GDaemon winPause{};
+		GW::CORE::GEventResponder levelEventHandler;
 
 		std::shared_ptr<SaveLoader> saveLoader;
+		std::shared_ptr<TimerWheel> timerWheel;
 
 		flecs::query<Player, Moveable> playerQuery;
 		flecs::query<Strawberry, FollowPlayer> followingStrawberriesQuery;
 
-		flecs::system springSystem;
-		flecs::system crystalCollectSystem;
-		flecs::system crystalRespawnSystem;
-		flecs::system spikeSystem;
-		flecs::system strawberrySystem;
-		flecs::system graveSystem;
-		flecs::system sceneExitSystem;
-		flecs::system crumblingPlatformCrumbleSystem;
-		flecs::system crumblingPlatformRespawnSystem;
+		flecs::system strawberryFollowSystem;
 
 		float strawberryFollowDist;
 		float strawberryFollowSmoothing;
@@ -53,6 +47,14 @@ namespace MAD
 		unsigned crumblingPlatformCrumbleTime;
 		unsigned crumblingPlatformRespawnTime;
 
+		// Crystals the player is inside of, they're retried every step until the player can use them
+		std::vector<flecs::entity_t> touchingCrystals;
+		// Spikes the player is inside of, they stay lethal every step the player overlaps them
+		std::vector<flecs::entity_t> touchingSpikes;
+		// Scene exits the player is inside of, they're hit again once a scene transition that turned them away is done
+		std::vector<flecs::entity_t> touchingSceneExits;
+		bool isHandlingContacts = false;
+
 	public:
 		bool Init(
 			std::shared_ptr<flecs::world> _flecsWorld,
@@ -61,27 +63,40 @@ namespace MAD
 			GW::CORE::GEventGenerator _levelEventPusher,
 			GW::CORE::GEventGenerator _gameStateEventPusher,
 			GW::CORE::GEventGenerator _touchEventPusher,
-			std::shared_ptr<SaveLoader> _saveLoader);
+			std::shared_ptr<SaveLoader> _saveLoader,
+			std::shared_ptr<TimerWheel> _timerWheel);
+
+		// Reacts to the player entering or leaving tile triggers, called by the physics step
+		void HandleContactEvents(const ContactEvents& _contactEvents);
 
 	private:
 
 		void InitEventHandlers();
-		void InitSpringSystem();
-		void InitCrystalSystems();
-		void InitSpikeSystem();
 		void InitStrawberrySystem();
-		void InitGraveSystem();
-		void InitSceneExitSystem();
-		void InitCrumblingPlatformSystems();
 
 		void PushPlayEvent(PlayEvent _event, PLAY_EVENT_DATA _data = {});
 		void PushLevelEvent(LEVEL_EVENT _event, LEVEL_EVENT_DATA _data = {});
 		void PushGameStateEvent(GAME_STATE _event, GAME_STATE_EVENT_DATA _data = {});
 
+		void DropAllContacts(flecs::entity _entity);
+		void CrumblePlatform(flecs::entity _entity);
+		void SetTileTimer(flecs::entity _entity, TileTimer _timer, TimerWheel::Handle _handle);
+
+		void OnPlayerEnterTile(flecs::entity _tile);
+		void OnPlayerExitTile(flecs::entity _tile);
+		void OnPlayerEnterSpring(flecs::entity _tile);
+		void OnPlayerTouchCrystal(flecs::entity _tile);
+		void OnPlayerTouchSpikes(flecs::entity _tile);
+		void OnPlayerEnterStrawberry(flecs::entity _tile);
+		void OnPlayerEnterGrave(flecs::entity _tile);
+		void OnPlayerEnterSceneExit(flecs::entity _tile);
+
 		void OnPlayerDestroyed(PLAY_EVENT_DATA _data);
 		void OnCollectStrawberries(PLAY_EVENT_DATA _data);
 		void OnCollectCrystal(PLAY_EVENT_DATA _data);
 
+		void OnEnterSceneDone(LEVEL_EVENT_DATA _data);
+
 		void OnEnterTouch(TouchEventData _data);
 		void OnExitTouch(TouchEventData _data);
 
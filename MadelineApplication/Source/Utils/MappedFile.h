@@ -0,0 +1,92 @@
+// Read only view of a whole file mapped into memory, pages are only read from disk once they're touched
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+
+namespace MAD
+{
+	class MappedFile
+	{
+		HANDLE file = INVALID_HANDLE_VALUE;
+		HANDLE mapping = NULL;
+		const UCHAR* view = nullptr;
+		size_t size = 0;
+
+	public:
+		MappedFile() = default;
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		~MappedFile()
+		{
+			Close();
+		}
+
+		bool Open(const std::string& _fileName)
+		{
+			Close();
+
+			file = CreateFileA(_fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+			if (file == INVALID_HANDLE_VALUE)
+				return false;
+
+			LARGE_INTEGER fileSize;
+			if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+			{
+				Close();
+				return false;
+			}
+
+			mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+			if (mapping == NULL)
+			{
+				Close();
+				return false;
+			}
+
+			view = (const UCHAR*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			if (view == nullptr)
+			{
+				Close();
+				return false;
+			}
+
+			size = (size_t)fileSize.QuadPart;
+			return true;
+		}
+
+		// The file can't be written while it's mapped
+		void Close()
+		{
+			if (view != nullptr)
+				UnmapViewOfFile(view);
+			if (mapping != NULL)
+				CloseHandle(mapping);
+			if (file != INVALID_HANDLE_VALUE)
+				CloseHandle(file);
+
+			view = nullptr;
+			mapping = NULL;
+			file = INVALID_HANDLE_VALUE;
+			size = 0;
+		}
+
+		bool IsOpen() const
+		{
+			return view != nullptr;
+		}
+
+		const UCHAR* GetData() const
+		{
+			return view;
+		}
+
+		size_t GetSize() const
+		{
+			return size;
+		}
+	};
+};
+
+#endif
@@ -0,0 +1,109 @@
+// Uniform grid used to cull pair tests down to objects sharing the same cells
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include <cmath>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+namespace MAD
+{
+	template <typename T>
+	class SpatialGrid
+	{
+		float cellSize;
+		float invCellSize;
+		std::unordered_map<UINT64, std::vector<T>> cells;
+		// cells that currently hold entries, so clearing doesn't have to walk the whole map
+		std::vector<std::vector<T>*> occupiedCells;
+
+	public:
+		SpatialGrid(float _cellSize = 1.0f)
+		{
+			SetCellSize(_cellSize);
+		}
+
+		void SetCellSize(float _cellSize)
+		{
+			cellSize = _cellSize > 0 ? _cellSize : 1.0f;
+			invCellSize = 1.0f / cellSize;
+			cells.clear();
+			occupiedCells.clear();
+		}
+
+		float GetCellSize() const
+		{
+			return cellSize;
+		}
+
+		// Empties every cell but keeps their storage so re-binning doesn't allocate
+		void Clear()
+		{
+			for (std::vector<T>* cell : occupiedCells)
+				cell->clear();
+
+			occupiedCells.clear();
+		}
+
+		bool IsEmpty() const
+		{
+			return occupiedCells.empty();
+		}
+
+		// Adds _value to every cell overlapped by the rectangle [_minX, _maxX] x [_minY, _maxY]
+		void Insert(const T& _value, float _minX, float _minY, float _maxX, float _maxY)
+		{
+			int minCellX = ToCell(_minX), minCellY = ToCell(_minY);
+			int maxCellX = ToCell(_maxX), maxCellY = ToCell(_maxY);
+
+			for (int cellY = minCellY; cellY <= maxCellY; cellY++)
+			{
+				for (int cellX = minCellX; cellX <= maxCellX; cellX++)
+				{
+					std::vector<T>& cell = cells[GetKey(cellX, cellY)];
+					if (cell.empty())
+						occupiedCells.push_back(&cell);
+					cell.push_back(_value);
+				}
+			}
+		}
+
+		// Appends every value in the cells overlapped by the rectangle to _outValues.
+		// Values spanning several cells are only appended once.
+		void Query(float _minX, float _minY, float _maxX, float _maxY, std::vector<T>& _outValues) const
+		{
+			size_t startSize = _outValues.size();
+			int minCellX = ToCell(_minX), minCellY = ToCell(_minY);
+			int maxCellX = ToCell(_maxX), maxCellY = ToCell(_maxY);
+
+			for (int cellY = minCellY; cellY <= maxCellY; cellY++)
+			{
+				for (int cellX = minCellX; cellX <= maxCellX; cellX++)
+				{
+					auto cell = cells.find(GetKey(cellX, cellY));
+					if (cell == cells.end())
+						continue;
+
+					_outValues.insert(_outValues.end(), cell->second.begin(), cell->second.end());
+				}
+			}
+
+			std::sort(_outValues.begin() + startSize, _outValues.end());
+			_outValues.erase(std::unique(_outValues.begin() + startSize, _outValues.end()), _outValues.end());
+		}
+
+	private:
+		inline int ToCell(float _coord) const
+		{
+			return (int)std::floor(_coord * invCellSize);
+		}
+
+		static inline UINT64 GetKey(int _cellX, int _cellY)
+		{
+			return ((UINT64)(UINT32)_cellX << 32) | (UINT64)(UINT32)_cellY;
+		}
+	};
+};
+
+#endif
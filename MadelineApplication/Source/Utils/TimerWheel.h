@@ -0,0 +1,199 @@
+// Hierarchical timer wheel running on game time, timers only advance while it's ticked so they pause with the game
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <vector>
+#include <functional>
+
+namespace MAD
+{
+	// Timers are bucketed by expiry millisecond in four wheels of 256 slots, the first wheel holds the next 256ms,
+	// each following wheel 256 times the span of the one before. Scheduling and cancelling are O(1), a tick only
+	// walks the slot expiring on it, and a higher wheel's slot is spread into the lower wheels when they wrap.
+	class TimerWheel
+	{
+	public:
+		typedef UINT64 Handle;
+		static constexpr Handle INVALID_HANDLE = 0;
+
+	private:
+		static constexpr UINT32 SLOT_BITS = 8;
+		static constexpr UINT32 SLOT_COUNT = 1 << SLOT_BITS;
+		static constexpr UINT32 SLOT_MASK = SLOT_COUNT - 1;
+		static constexpr UINT32 WHEEL_COUNT = 4;
+
+		enum TimerState : UCHAR { FREE, SCHEDULED, CANCELLED };
+
+		struct Timer
+		{
+			std::function<void()> callback;
+			UINT64 expireTick;
+			// Bumped when the timer is freed so stale handles can't cancel whatever reuses it
+			UINT32 generation;
+			TimerState state;
+		};
+
+		std::vector<Timer> timers;
+		std::vector<UINT32> freeTimers;
+		std::vector<UINT32> wheels[WHEEL_COUNT][SLOT_COUNT];
+		// Slot being fired, callbacks can schedule, cancel or clear while it's walked
+		std::vector<UINT32> expiring;
+		size_t expiringIndex = 0;
+
+		UINT64 currentTick = 0;
+		double pendingMilliseconds = 0;
+		// Bumped by Clear so Advance stops ticking when a callback clears the wheel
+		UINT32 clearGeneration = 0;
+
+	public:
+		// Calls _callback once _delayMilliseconds of game time have passed, at least one tick from now
+		Handle Schedule(UINT32 _delayMilliseconds, std::function<void()> _callback)
+		{
+			UINT32 index;
+			if (freeTimers.empty())
+			{
+				index = (UINT32)timers.size();
+				timers.push_back({ nullptr, 0, 1, FREE });
+			}
+			else
+			{
+				index = freeTimers.back();
+				freeTimers.pop_back();
+			}
+
+			Timer& timer = timers[index];
+			timer.callback = std::move(_callback);
+			timer.expireTick = currentTick + max(_delayMilliseconds, 1u);
+			timer.state = SCHEDULED;
+			Place(index);
+
+			return ((Handle)timer.generation << 32) | index;
+		}
+
+		// Stops a timer that hasn't fired yet, does nothing for fired, cancelled or invalid handles
+		void Cancel(Handle _handle)
+		{
+			UINT32 index = (UINT32)_handle;
+			if (_handle == INVALID_HANDLE || index >= timers.size())
+				return;
+
+			Timer& timer = timers[index];
+			if (timer.generation != (UINT32)(_handle >> 32) || timer.state != SCHEDULED)
+				return;
+
+			// The timer is still in a slot, it's freed when the wheel reaches it
+			timer.state = CANCELLED;
+			timer.callback = nullptr;
+		}
+
+		// Drops every pending timer without calling them
+		void Clear()
+		{
+			for (auto& wheel : wheels)
+			{
+				for (std::vector<UINT32>& slot : wheel)
+				{
+					for (UINT32 index : slot)
+						Free(index);
+					slot.clear();
+				}
+			}
+
+			for (; expiringIndex < expiring.size(); expiringIndex++)
+				Free(expiring[expiringIndex]);
+
+			pendingMilliseconds = 0;
+			clearGeneration++;
+		}
+
+		// Moves the clock forward by _deltaTime seconds, firing timers in expiry order
+		void Advance(float _deltaTime)
+		{
+			pendingMilliseconds += _deltaTime * 1000.0;
+			UINT64 ticks = (UINT64)pendingMilliseconds;
+			pendingMilliseconds -= (double)ticks;
+
+			UINT32 startGeneration = clearGeneration;
+			for (UINT64 tick = 0; tick < ticks && clearGeneration == startGeneration; tick++)
+				Tick();
+		}
+
+	private:
+		void Tick()
+		{
+			currentTick++;
+
+			// Every time a wheel wraps, the next wheel's current slot is spread over the wheels below it
+			for (UINT32 wheel = 1; wheel < WHEEL_COUNT; wheel++)
+			{
+				if (((currentTick >> (SLOT_BITS * (wheel - 1))) & SLOT_MASK) != 0)
+					break;
+
+				Cascade(wheel, (UINT32)(currentTick >> (SLOT_BITS * wheel)) & SLOT_MASK);
+			}
+
+			expiring.clear();
+			expiring.swap(wheels[0][currentTick & SLOT_MASK]);
+
+			for (expiringIndex = 0; expiringIndex < expiring.size(); expiringIndex++)
+			{
+				UINT32 index = expiring[expiringIndex];
+				if (timers[index].state == FREE)
+					continue;
+
+				// Move the callback out first, it may schedule timers that grow the pool
+				std::function<void()> callback = std::move(timers[index].callback);
+				bool isScheduled = timers[index].state == SCHEDULED;
+				Free(index);
+
+				if (isScheduled && callback)
+					callback();
+			}
+		}
+
+		void Cascade(UINT32 _wheel, UINT32 _slot)
+		{
+			std::vector<UINT32> cascading;
+			cascading.swap(wheels[_wheel][_slot]);
+
+			for (UINT32 index : cascading)
+			{
+				if (timers[index].state == CANCELLED)
+					Free(index);
+				else if (timers[index].state == SCHEDULED)
+					Place(index);
+			}
+
+			// Hand the storage back so the slot doesn't allocate next time around
+			cascading.clear();
+			if (wheels[_wheel][_slot].empty())
+				wheels[_wheel][_slot].swap(cascading);
+		}
+
+		void Place(UINT32 _index)
+		{
+			UINT64 expireTick = timers[_index].expireTick;
+			UINT64 delta = expireTick > currentTick ? expireTick - currentTick : 0;
+
+			UINT32 wheel = 0;
+			while (wheel < WHEEL_COUNT - 1 && delta >= (1ull << (SLOT_BITS * (wheel + 1))))
+				wheel++;
+
+			wheels[wheel][(expireTick >> (SLOT_BITS * wheel)) & SLOT_MASK].push_back(_index);
+		}
+
+		void Free(UINT32 _index)
+		{
+			Timer& timer = timers[_index];
+			if (timer.state == FREE)
+				return;
+
+			timer.callback = nullptr;
+			timer.state = FREE;
+			timer.generation++;
+			freeTimers.push_back(_index);
+		}
+	};
+};
+
+#endif
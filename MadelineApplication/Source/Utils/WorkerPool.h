@@ -0,0 +1,128 @@
+// Persistent threads that split an index range between them, the calling thread works the first slice
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace MAD
+{
+	class WorkerPool
+	{
+		std::vector<std::thread> threads;
+		std::mutex mutex;
+		std::condition_variable workReady;
+		std::condition_variable workDone;
+
+		const std::function<void(UINT32, UINT32, UINT32)>* job = nullptr;
+		UINT32 jobSize = 0;
+		UINT32 sliceCount = 0;
+		UINT32 pendingSlices = 0;
+		UINT64 generation = 0;
+		bool isStopping = false;
+
+	public:
+		~WorkerPool()
+		{
+			Stop();
+		}
+
+		// _threadCount includes the calling thread, 0 uses every core
+		void Start(UINT32 _threadCount)
+		{
+			Stop();
+
+			if (_threadCount == 0)
+				_threadCount = max(std::thread::hardware_concurrency(), 1u);
+
+			isStopping = false;
+			// Handed over rather than read by the thread, a job started before it first takes the lock would be missed
+			for (UINT32 worker = 1; worker < _threadCount; worker++)
+				threads.emplace_back(&WorkerPool::WorkerLoop, this, worker, generation);
+		}
+
+		void Stop()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				isStopping = true;
+			}
+			workReady.notify_all();
+
+			for (std::thread& thread : threads)
+				thread.join();
+			threads.clear();
+		}
+
+		UINT32 GetThreadCount() const
+		{
+			return (UINT32)threads.size() + 1;
+		}
+
+		// Calls _job(begin, end, slice) over contiguous slices of [0, _count), in slice order of the range,
+		// each at least _minPerSlice long. Returns once every slice is done.
+		void ParallelFor(UINT32 _count, UINT32 _minPerSlice, const std::function<void(UINT32, UINT32, UINT32)>& _job)
+		{
+			UINT32 slices = min(GetThreadCount(), max(_count / max(_minPerSlice, 1u), 1u));
+			if (slices <= 1)
+			{
+				if (_count > 0)
+					_job(0, _count, 0);
+				return;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				job = &_job;
+				jobSize = _count;
+				sliceCount = slices;
+				pendingSlices = slices - 1;
+				generation++;
+			}
+			workReady.notify_all();
+
+			RunSlice(0);
+
+			std::unique_lock<std::mutex> lock(mutex);
+			workDone.wait(lock, [this] { return pendingSlices == 0; });
+			job = nullptr;
+		}
+
+	private:
+		void RunSlice(UINT32 _slice)
+		{
+			UINT32 begin = (UINT32)((UINT64)jobSize * _slice / sliceCount);
+			UINT32 end = (UINT32)((UINT64)jobSize * (_slice + 1) / sliceCount);
+			(*job)(begin, end, _slice);
+		}
+
+		void WorkerLoop(UINT32 _worker, UINT64 _startGeneration)
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			UINT64 seenGeneration = _startGeneration;
+
+			while (true)
+			{
+				workReady.wait(lock, [this, &seenGeneration] { return isStopping || generation != seenGeneration; });
+				if (isStopping)
+					return;
+
+				seenGeneration = generation;
+				if (_worker >= sliceCount)
+					continue;
+
+				lock.unlock();
+				RunSlice(_worker);
+				lock.lock();
+
+				if (--pendingSlices == 0)
+					workDone.notify_one();
+			}
+		}
+	};
+};
+
+#endif
@@ -42652,7 +42652,7 @@ void flecs_override_copy(
     int32_t i;
     if (copy) {
         for (i = 0; i < count; i ++) {
-            copy(dst, src, count, ti);
+            copy(dst, src, 1, ti);
             dst = ECS_OFFSET(dst, size);
         }
     } else {